@@ -0,0 +1,65 @@
+// Smallest host for MorseInput: one view, keyed text logged as it arrives.
+// Built as its own fap from application.fam so the View and its use of
+// morse_core are compiled with every build of the app.
+
+#include <furi.h>
+#include <gui/gui.h>
+#include <gui/view_dispatcher.h>
+
+#include "../morse_input.h"
+
+typedef enum {
+    DemoViewMorse,
+} DemoView;
+
+typedef struct {
+    ViewDispatcher* view_dispatcher;
+    MorseInput* morse_input;
+} MorseInputDemo;
+
+// Runs on the timer or GUI thread, so only log
+static void demo_character_callback(char character, void* context) {
+    UNUSED(context);
+    if(character == '\b') {
+        FURI_LOG_I("MorseInputDemo", "Deleted");
+    } else {
+        FURI_LOG_I("MorseInputDemo", "Keyed '%c'", character);
+    }
+}
+
+// BACK leaves the demo
+static bool demo_navigation_callback(void* context) {
+    UNUSED(context);
+    return false;
+}
+
+int32_t morse_input_demo_app(void* p) {
+    UNUSED(p);
+    MorseInputDemo* demo = malloc(sizeof(MorseInputDemo));
+
+    demo->morse_input = morse_input_alloc();
+    morse_input_set_header(demo->morse_input, "Key some text");
+    morse_input_set_gaps(demo->morse_input, 0, 4000);
+    morse_input_set_callback(demo->morse_input, demo_character_callback, demo);
+
+    demo->view_dispatcher = view_dispatcher_alloc();
+    view_dispatcher_set_event_callback_context(demo->view_dispatcher, demo);
+    view_dispatcher_set_navigation_event_callback(demo->view_dispatcher, demo_navigation_callback);
+    view_dispatcher_add_view(demo->view_dispatcher, DemoViewMorse, morse_input_get_view(demo->morse_input));
+
+    Gui* gui = furi_record_open(RECORD_GUI);
+    view_dispatcher_attach_to_gui(demo->view_dispatcher, gui, ViewDispatcherTypeFullscreen);
+    view_dispatcher_switch_to_view(demo->view_dispatcher, DemoViewMorse);
+    view_dispatcher_run(demo->view_dispatcher);
+
+    char text[MORSE_INPUT_TEXT_MAX + 1];
+    morse_input_get_text(demo->morse_input, text, sizeof(text));
+    FURI_LOG_I("MorseInputDemo", "Text: %s", text);
+
+    view_dispatcher_remove_view(demo->view_dispatcher, DemoViewMorse);
+    view_dispatcher_free(demo->view_dispatcher);
+    morse_input_free(demo->morse_input);
+    furi_record_close(RECORD_GUI);
+    free(demo);
+    return 0;
+}
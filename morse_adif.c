@@ -0,0 +1,191 @@
+#include "morse_adif.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#define PREFILL_TOKEN_MAX 16       // Longer words are never a field
+
+const char* const ADIF_BANDS[ADIF_BAND_COUNT] = {
+    "160m", "80m", "60m", "40m", "30m", "20m", "17m", "15m", "12m", "10m", "2m",
+};
+
+// Closing words that never make an exchange
+static const char* const PREFILL_SKIP[] = {"DE", "TU", "BK", "K", "KN", "R", "73", "AR", "SK", "CQ"};
+
+size_t adif_header(char* out, size_t size, const char* program) {
+    int length = snprintf(
+        out, size, "%s ADIF export\n<ADIF_VER:5>3.1.4 <PROGRAMID:%u>%s <EOH>\n", program,
+        (unsigned)strlen(program), program);
+    return (length > 0 && (size_t)length < size) ? (size_t)length : 0;
+}
+
+// One "<NAME:length>value " field; empty values are left out
+static size_t adif_field(char* out, size_t size, const char* name, const char* value) {
+    size_t value_length = strlen(value);
+    if(value_length == 0) return 0;
+    int length = snprintf(out, size, "<%s:%u>%s ", name, (unsigned)value_length, value);
+    return (length > 0 && (size_t)length < size) ? (size_t)length : size;
+}
+
+// Days since 1970-01-01 to a civil date, valid for any 32-bit timestamp
+static void adif_civil_date(uint32_t days, uint16_t* year, uint8_t* month, uint8_t* day) {
+    uint32_t z = days + 719468;
+    uint32_t era = z / 146097;
+    uint32_t day_of_era = z - era * 146097;
+    uint32_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    uint32_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    uint32_t shifted_month = (5 * day_of_year + 2) / 153;
+
+    *day = (uint8_t)(day_of_year - (153 * shifted_month + 2) / 5 + 1);
+    *month = (uint8_t)(shifted_month < 10 ? shifted_month + 3 : shifted_month - 9);
+    *year = (uint16_t)(year_of_era + era * 400 + (*month <= 2));
+}
+
+size_t adif_record(char* out, size_t size, const AdifQso* qso) {
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    adif_civil_date(qso->timestamp / 86400, &year, &month, &day);
+    uint32_t seconds = qso->timestamp % 86400;
+
+    char date[12];
+    char time[8];
+    snprintf(date, sizeof(date), "%04u%02u%02u", year, month, day);
+    snprintf(time, sizeof(time), "%02lu%02lu%02lu", (unsigned long)(seconds / 3600),
+             (unsigned long)(seconds / 60 % 60), (unsigned long)(seconds % 60));
+
+    size_t length = 0;
+    length += adif_field(out + length, size - length, "CALL", qso->call);
+    if(length < size) length += adif_field(out + length, size - length, "QSO_DATE", date);
+    if(length < size) length += adif_field(out + length, size - length, "TIME_ON", time);
+    if(length < size) length += adif_field(out + length, size - length, "BAND", qso->band);
+    if(length < size) length += adif_field(out + length, size - length, "MODE", "CW");
+    if(length < size) length += adif_field(out + length, size - length, "RST_SENT", qso->rst_sent);
+    if(length < size) length += adif_field(out + length, size - length, "RST_RCVD", qso->rst_rcvd);
+    if(length < size) length += adif_field(out + length, size - length, "SRX_STRING", qso->exchange);
+    if(length + sizeof("<EOR>\n") > size) return 0;
+
+    memcpy(out + length, "<EOR>\n", sizeof("<EOR>\n"));
+    return length + sizeof("<EOR>\n") - 1;
+}
+
+void adif_writer_init(AdifWriter* writer, AdifFlushCallback flush, void* context) {
+    writer->length = 0;
+    writer->flush = flush;
+    writer->context = context;
+}
+
+bool adif_writer_flush(AdifWriter* writer) {
+    if(writer->length == 0) return true;
+    bool ok = writer->flush(writer->buffer, writer->length, writer->context);
+    if(ok) writer->length = 0;
+    return ok;
+}
+
+bool adif_writer_append(AdifWriter* writer, const AdifQso* qso) {
+    char record[ADIF_RECORD_MAX];
+    size_t length = adif_record(record, sizeof(record), qso);
+    if(length == 0) return false;
+
+    if(writer->length + length > sizeof(writer->buffer) && !adif_writer_flush(writer)) return false;
+    memcpy(writer->buffer + writer->length, record, length);
+    writer->length += length;
+    return true;
+}
+
+// RST as sent on the air: readability 1-5, then two digits or cut 9s
+static bool prefill_is_rst(const char* token) {
+    if(strlen(token) != 3 || token[0] < '1' || token[0] > '5') return false;
+    for(int i = 1; i < 3; i++) {
+        if(token[i] != 'N' && (token[i] < '1' || token[i] > '9')) return false;
+    }
+    return true;
+}
+
+// Letters and digits ending in a letter, optionally with /-separated parts
+static bool prefill_is_callsign(const char* token) {
+    size_t length = strlen(token);
+    if(length < 3 || length > ADIF_CALL_MAX || prefill_is_rst(token)) return false;
+
+    bool letter = false;
+    bool digit = false;
+    char last = 0;
+    for(size_t i = 0; i < length; i++) {
+        char c = token[i];
+        if(c == '/') {
+            if(i == 0 || i == length - 1) return false;
+            continue;
+        }
+        if(isdigit((unsigned char)c)) {
+            digit = true;
+        } else if(isalpha((unsigned char)c)) {
+            letter = true;
+        } else {
+            return false;
+        }
+        if(i == 0 || token[i - 1] != '/') last = c;
+    }
+    return letter && digit && (isalpha((unsigned char)last) || strchr(token, '/'));
+}
+
+static bool prefill_is_skipped(const char* token) {
+    for(size_t i = 0; i < sizeof(PREFILL_SKIP) / sizeof(PREFILL_SKIP[0]); i++) {
+        if(strcmp(token, PREFILL_SKIP[i]) == 0) return true;
+    }
+    return strpbrk(token, "?*") != NULL;  // A question, or a code the decoder did not know
+}
+
+// Copies the next word, uppercased, and returns the text after it (NULL at the end)
+static const char* prefill_next_token(const char* text, char* token) {
+    while(*text == ' ') text++;
+    if(*text == '\0') return NULL;
+
+    size_t length = 0;
+    for(; *text != '\0' && *text != ' '; text++) {
+        if(length < PREFILL_TOKEN_MAX) token[length] = (char)toupper((unsigned char)*text);
+        length++;
+    }
+    token[length <= PREFILL_TOKEN_MAX ? length : 0] = '\0';
+    return text;
+}
+
+void adif_prefill(AdifQso* qso, const char* transcript) {
+    char token[PREFILL_TOKEN_MAX + 1];
+    char previous[PREFILL_TOKEN_MAX + 1] = "";
+    char first_call[ADIF_CALL_MAX + 1] = "";
+    char de_call[ADIF_CALL_MAX + 1] = "";
+    bool after_rst = false;
+
+    const char* text = transcript;
+    while((text = prefill_next_token(text, token)) != NULL) {
+        if(prefill_is_callsign(token)) {
+            // The station after DE is the one sending; otherwise the first heard
+            if(strcmp(previous, "DE") == 0) strcpy(de_call, token);
+            if(first_call[0] == '\0') strcpy(first_call, token);
+        } else if(prefill_is_rst(token)) {
+            for(int i = 0; i < 3; i++) {
+                qso->rst_rcvd[i] = (token[i] == 'N') ? '9' : token[i];
+            }
+            qso->rst_rcvd[3] = '\0';
+            qso->exchange[0] = '\0';
+            after_rst = true;
+            strcpy(previous, token);
+            continue;
+        }
+
+        // The word after the last RST is the exchange
+        if(after_rst && token[0] != '\0' && !prefill_is_skipped(token) && !prefill_is_callsign(token) &&
+           strlen(token) <= ADIF_EXCHANGE_MAX) {
+            strcpy(qso->exchange, token);
+        }
+        after_rst = false;
+        strcpy(previous, token);
+    }
+
+    if(de_call[0] != '\0') {
+        strcpy(qso->call, de_call);
+    } else if(first_call[0] != '\0') {
+        strcpy(qso->call, first_call);
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+// ADIF QSO logging: record formatting, a buffered append-only writer and
+// prefill from a decoded transcript. No Flipper SDK dependencies, so the
+// host tools in tools/ produce byte-identical output.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ADIF_CALL_MAX 12
+#define ADIF_BAND_MAX 5
+#define ADIF_RST_MAX 3
+#define ADIF_EXCHANGE_MAX 12
+#define ADIF_RECORD_MAX 192        // Longest formatted record
+#define ADIF_BUFFER_SIZE 512       // Records collected before a write
+#define ADIF_BAND_COUNT 11
+
+typedef struct {
+    char call[ADIF_CALL_MAX + 1];
+    uint32_t timestamp;                 // UTC seconds since 1970
+    char band[ADIF_BAND_MAX + 1];
+    char rst_sent[ADIF_RST_MAX + 1];
+    char rst_rcvd[ADIF_RST_MAX + 1];
+    char exchange[ADIF_EXCHANGE_MAX + 1];  // Received exchange, SRX_STRING
+} AdifQso;
+
+// Receives whole records only; returns false if they could not be stored
+typedef bool (*AdifFlushCallback)(const char* data, size_t length, void* context);
+
+typedef struct {
+    char buffer[ADIF_BUFFER_SIZE];
+    size_t length;
+    AdifFlushCallback flush;
+    void* context;
+} AdifWriter;
+
+extern const char* const ADIF_BANDS[ADIF_BAND_COUNT];
+
+// Formatting; both return the length written, 0 if it did not fit
+size_t adif_header(char* out, size_t size, const char* program);
+size_t adif_record(char* out, size_t size, const AdifQso* qso);
+
+// Writer: records collect in the buffer and reach the callback when it is full
+// or on flush. Nothing already written is ever read back or rewritten.
+void adif_writer_init(AdifWriter* writer, AdifFlushCallback flush, void* context);
+bool adif_writer_append(AdifWriter* writer, const AdifQso* qso);
+bool adif_writer_flush(AdifWriter* writer);
+
+// Fill call, RST received and exchange from decoded text, keeping fields it
+// finds nothing for; cut numbers in the RST are expanded (5NN -> 599)
+void adif_prefill(AdifQso* qso, const char* transcript);
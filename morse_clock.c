@@ -0,0 +1,26 @@
+#include "morse_clock.h"
+
+#include <furi.h>
+#include <furi_hal.h>
+
+// The tick and SysTick are read as a pair: a tick that moves between the two
+// reads means the counter reloaded in between, so the pair is taken again.
+// With interrupts masked the tick cannot move, so a reload still waiting in
+// SysTick's pending bit is counted here instead.
+uint32_t morse_clock_us(void) {
+    uint32_t tick;
+    uint32_t value;
+    bool reload_pending;
+    do {
+        tick = furi_get_tick();
+        value = SysTick->VAL;
+        reload_pending = (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0;
+    } while(tick != furi_get_tick());
+
+    uint32_t period = SysTick->LOAD + 1;
+    uint32_t counted = period - 1 - value;  // SysTick counts down
+    if(reload_pending && counted < period / 2) tick++;
+
+    uint32_t tick_us = 1000000u / furi_kernel_get_tick_frequency();
+    return tick * tick_us + (uint32_t)((uint64_t)counted * tick_us / period);
+}
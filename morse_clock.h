@@ -0,0 +1,15 @@
+#pragma once
+
+// Microsecond timestamps for key edges and latency. The whole milliseconds
+// come from the kernel tick, which the firmware steps forward after tickless
+// sleep, so idle time is never lost; the part within the current tick comes
+// from the SysTick down-counter. Neither the cycle counter nor SysTick runs
+// while the core sleeps, so straight after a wake the sub-millisecond part
+// restarts and a timestamp can be up to one tick early. Safe from threads
+// and interrupts alike.
+
+#include <stdint.h>
+
+// Free-running microseconds, wrapping after about 71 minutes. Compare two
+// timestamps by unsigned subtraction, never by magnitude.
+uint32_t morse_clock_us(void);
@@ -0,0 +1,632 @@
+#include "morse_core.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+// International Morse Code mappings. The order is fixed: the charset masks in
+// morse_core.h and saved confusion matrices are indexed by position.
+const MorseCode MORSE_TABLE[] = {
+    {'A', ".-"},
+    {'B', "-..."},
+    {'C', "-.-."},
+    {'D', "-.."},
+    {'E', "."},
+    {'F', "..-."},
+    {'G', "--."},
+    {'H', "...."},
+    {'I', ".."},
+    {'J', ".---"},
+    {'K', "-.-"},
+    {'L', ".-.."},
+    {'M', "--"},
+    {'N', "-."},
+    {'O', "---"},
+    {'P', ".--."},
+    {'Q', "--.-"},
+    {'R', ".-."},
+    {'S', "..."},
+    {'T', "-"},
+    {'U', "..-"},
+    {'V', "...-"},
+    {'W', ".--"},
+    {'X', "-..-"},
+    {'Y', "-.--"},
+    {'Z', "--.."},
+    {'0', "-----"},
+    {'1', ".----"},
+    {'2', "..---"},
+    {'3', "...--"},
+    {'4', "....-"},
+    {'5', "....."},
+    {'6', "-...."},
+    {'7', "--..."},
+    {'8', "---.."},
+    {'9', "----."},
+    {'.', ".-.-.-"},
+    {',', "--..--"},
+    {'?', "..--.."},
+    {'\'', ".----."},
+    {'!', "-.-.--"},
+    {'/', "-..-."},
+    {'(', "-.--."},    // Also KN
+    {')', "-.--.-"},
+    {'&', ".-..."},    // Also AS
+    {':', "---..."},
+    {';', "-.-.-."},
+    {'=', "-...-"},    // Also BT
+    {'+', ".-.-."},    // Also AR
+    {'-', "-....-"},
+    {'"', ".-..-."},
+    {'@', ".--.-."},
+    {'>', "...-.-"},   // SK
+};
+
+_Static_assert(sizeof(MORSE_TABLE) / sizeof(MORSE_TABLE[0]) == MORSE_TABLE_SIZE, "MORSE_TABLE_SIZE out of date");
+
+// Get table index for a character, -1 if not in the table
+int get_table_index_for_char(char c) {
+    c = toupper(c);
+
+    for(size_t i = 0; i < MORSE_TABLE_SIZE; i++) {
+        if(MORSE_TABLE[i].character == c) {
+            return (int)i;
+        }
+    }
+
+    return -1;
+}
+
+// Get morse code for a character
+const char* get_morse_for_char(char c) {
+    int index = get_table_index_for_char(c);
+    return (index >= 0) ? MORSE_TABLE[index].code : NULL;
+}
+
+// Get character for a morse code
+char get_char_for_morse(const char* morse) {
+    for(size_t i = 0; i < MORSE_TABLE_SIZE; i++) {
+        if(strcmp(MORSE_TABLE[i].code, morse) == 0) {
+            return MORSE_TABLE[i].character;
+        }
+    }
+
+    return MORSE_UNKNOWN;
+}
+
+// Members after and before index, wrapping; -1 for an empty set
+int morse_charset_next(MorseCharset set, int index) {
+    if(set == 0) return -1;
+    MorseCharset after = (index + 1 < 64) ? set & ~((MORSE_CHARSET_BIT(index + 1)) - 1) : 0;
+    return __builtin_ctzll(after ? after : set);
+}
+
+int morse_charset_previous(MorseCharset set, int index) {
+    if(set == 0) return -1;
+    MorseCharset before = (index > 0) ? set & (MORSE_CHARSET_BIT(index) - 1) : 0;
+    return 63 - __builtin_clzll(before ? before : set);
+}
+
+uint8_t morse_charset_count(MorseCharset set) {
+    return (uint8_t)__builtin_popcountll(set);
+}
+
+// The member of the given rank, lowest first: a byte at a time, then a bit at
+// a time, so the cost is bounded whatever the set
+int morse_charset_select(MorseCharset set, uint8_t rank) {
+    for(int base = 0; base < 64; base += 8) {
+        uint8_t byte = (uint8_t)(set >> base);
+        uint8_t count = (uint8_t)__builtin_popcount(byte);
+        if(rank >= count) {
+            rank -= count;
+            continue;
+        }
+        for(int bit = 0; bit < 8; bit++) {
+            if((byte & (1u << bit)) && rank-- == 0) return base + bit;
+        }
+    }
+    return -1;
+}
+
+int morse_charset_sample(MorseCharset set, MorseRng* rng) {
+    uint8_t count = morse_charset_count(set);
+    return count ? morse_charset_select(set, (uint8_t)morse_rng_range(rng, count)) : -1;
+}
+
+MorseCharset morse_charset_from_text(const char* text) {
+    MorseCharset set = 0;
+    for(; *text; text++) {
+        int index = get_table_index_for_char(*text);
+        if(index >= 0) set |= MORSE_CHARSET_BIT(index);
+    }
+    return set;
+}
+
+static const struct {
+    char character;
+    const char* name;
+} MORSE_PROSIGNS[] = {{'(', "KN"}, {'&', "AS"}, {'=', "BT"}, {'+', "AR"}, {'>', "SK"}};
+
+const char* morse_prosign_name(char character) {
+    for(size_t i = 0; i < sizeof(MORSE_PROSIGNS) / sizeof(MORSE_PROSIGNS[0]); i++) {
+        if(MORSE_PROSIGNS[i].character == character) return MORSE_PROSIGNS[i].name;
+    }
+    return NULL;
+}
+
+// Expand a 32-bit seed into the generator state with splitmix32
+void morse_rng_seed(MorseRng* rng, uint32_t seed) {
+    for(size_t i = 0; i < 4; i++) {
+        uint32_t z = (seed += 0x9E3779B9u);
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        rng->s[i] = z ^ (z >> 16);
+    }
+}
+
+static inline uint32_t morse_rng_rotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+// Next 32-bit value
+uint32_t morse_rng_next(MorseRng* rng) {
+    uint32_t* s = rng->s;
+    const uint32_t result = morse_rng_rotl(s[1] * 5, 7) * 9;
+    const uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = morse_rng_rotl(s[3], 11);
+
+    return result;
+}
+
+// Uniform value in [0, n) using a multiply-shift instead of a division
+uint32_t morse_rng_range(MorseRng* rng, uint32_t n) {
+    return (uint32_t)(((uint64_t)morse_rng_next(rng) * n) >> 32);
+}
+
+// Length of one dot in milliseconds (PARIS timing)
+uint16_t morse_unit_ms(uint8_t wpm) {
+    if(wpm < MIN_WPM) wpm = MIN_WPM;
+    if(wpm > MAX_WPM) wpm = MAX_WPM;
+    return 1200 / wpm;
+}
+
+// Append one schedule element in dot units, merging consecutive spaces
+static bool schedule_push(MorseSchedule* schedule, int16_t units) {
+    if(units < 0 && schedule->count > 0 && schedule->elements[schedule->count - 1] < 0) {
+        // Gaps never stack: the longer one (element, letter or word) wins
+        if(units < schedule->elements[schedule->count - 1]) {
+            schedule->elements[schedule->count - 1] = units;
+        }
+        return true;
+    }
+    if(schedule->count >= SCHEDULE_MAX_ELEMENTS) return false;
+    schedule->elements[schedule->count++] = units;
+    return true;
+}
+
+// Encode text into a schedule in dot units, ending with a letter gap.
+// Unknown characters are skipped. Returns false if the schedule ran out of room.
+bool encode_units(MorseSchedule* schedule, const char* text) {
+    bool complete = true;
+    schedule->count = 0;
+
+    for(size_t i = 0; text[i] != '\0' && complete; i++) {
+        if(text[i] == ' ') {
+            complete = schedule_push(schedule, -7);
+            continue;
+        }
+
+        const char* code = get_morse_for_char(text[i]);
+        if(!code) continue;
+
+        for(size_t j = 0; code[j] != '\0' && complete; j++) {
+            complete = schedule_push(schedule, code[j] == '-' ? 3 : 1) && schedule_push(schedule, -1);
+        }
+        complete = complete && schedule_push(schedule, -3);
+    }
+
+    return complete;
+}
+
+// Scale a schedule from dot units to milliseconds. Element edges are placed at
+// rounded multiples of the exact 1200/wpm ms unit, so fast speeds with a
+// fractional unit stay calibrated over a whole group.
+void schedule_units_to_ms(MorseSchedule* schedule, uint8_t wpm) {
+    if(wpm < MIN_WPM) wpm = MIN_WPM;
+    if(wpm > MAX_WPM) wpm = MAX_WPM;
+    uint32_t units = 0;
+    uint32_t edge_ms = 0;
+    for(uint16_t i = 0; i < schedule->count; i++) {
+        int16_t element = schedule->elements[i];
+        units += (element > 0) ? element : -element;
+        uint32_t next_edge_ms = (units * 1200 + wpm / 2) / wpm;
+        int16_t duration = (int16_t)(next_edge_ms - edge_ms);
+        schedule->elements[i] = (element > 0) ? duration : -duration;
+        edge_ms = next_edge_ms;
+    }
+}
+
+// Encode text into a keying schedule at the given speed, ending with a letter gap
+bool encode_schedule(MorseSchedule* schedule, const char* text, uint8_t wpm) {
+    bool complete = encode_units(schedule, text);
+    schedule_units_to_ms(schedule, wpm);
+    return complete;
+}
+
+// Reset the decoder to a starting speed
+void morse_decoder_init(MorseDecoder* decoder, uint8_t wpm, MorseDecoderCallback callback, void* context) {
+    memset(decoder, 0, sizeof(MorseDecoder));
+    decoder->dot_us = morse_unit_ms(wpm) * 1000;
+    decoder->callback = callback;
+    decoder->context = context;
+}
+
+// Emit the collected code as a character
+void morse_decoder_flush(MorseDecoder* decoder) {
+    if(decoder->code_length == 0) return;
+
+    decoder->code[decoder->code_length] = '\0';
+    char decoded = decoder->overflow ? MORSE_UNKNOWN : get_char_for_morse(decoder->code);
+    decoder->code_length = 0;
+    decoder->overflow = false;
+    if(decoder->callback) decoder->callback(decoded, decoder->context);
+}
+
+// Classify a mark against the dot estimate and let the estimate follow the sender
+void morse_decoder_mark(MorseDecoder* decoder, uint32_t duration_us) {
+    bool dash = duration_us >= 2 * decoder->dot_us;
+
+    if(decoder->code_length < DECODER_MAX_CODE) {
+        decoder->code[decoder->code_length++] = dash ? '-' : '.';
+    } else {
+        decoder->overflow = true;
+    }
+
+    // Dashes count as three dots; the average moves a quarter of the way
+    uint32_t sample_us = dash ? duration_us / 3 : duration_us;
+    decoder->dot_us = (3 * decoder->dot_us + sample_us) / 4;
+
+    const uint32_t fastest_us = 1200000 / MAX_WPM;
+    const uint32_t slowest_us = 1200000 / MIN_WPM;
+    if(decoder->dot_us < fastest_us) decoder->dot_us = fastest_us;
+    if(decoder->dot_us > slowest_us) decoder->dot_us = slowest_us;
+}
+
+// A space ends the character after 2 dots and the word after 5
+void morse_decoder_space(MorseDecoder* decoder, uint32_t duration_us) {
+    if(duration_us < 2 * decoder->dot_us) return;
+
+    bool had_code = decoder->code_length > 0;
+    morse_decoder_flush(decoder);
+    if(had_code && duration_us >= 5 * decoder->dot_us && decoder->callback) {
+        decoder->callback(' ', decoder->context);
+    }
+}
+
+void morse_filter_init(MorseGlitchFilter* filter, MorseDecoder* decoder, uint8_t percent) {
+    memset(filter, 0, sizeof(MorseGlitchFilter));
+    filter->decoder = decoder;
+    filter->percent = percent;
+}
+
+void morse_filter_flush(MorseGlitchFilter* filter) {
+    if(!filter->pending) return;
+    if(filter->pending_down) {
+        morse_decoder_mark(filter->decoder, filter->pending_us);
+    } else {
+        morse_decoder_space(filter->decoder, filter->pending_us);
+    }
+    filter->pending = false;
+}
+
+// The minimum follows the decoder's speed estimate, so it scales with the sender
+void morse_filter_run(MorseGlitchFilter* filter, bool key_down, uint32_t duration_us) {
+    if(filter->percent == 0) {
+        filter->pending = true;
+        filter->pending_down = key_down;
+        filter->pending_us = duration_us;
+        morse_filter_flush(filter);
+        return;
+    }
+
+    uint32_t minimum_us = filter->decoder->dot_us * filter->percent / 100;
+    if(filter->pending && key_down == filter->pending_down) {
+        // The run after a glitch, or a repeated level: one longer run
+        filter->pending_us += duration_us;
+    } else if(duration_us < minimum_us) {
+        if(filter->pending) filter->pending_us += duration_us;
+        filter->suppressed++;
+    } else {
+        morse_filter_flush(filter);
+        filter->pending = true;
+        filter->pending_down = key_down;
+        filter->pending_us = duration_us;
+    }
+}
+
+uint8_t morse_quantise_schedule(MorseSchedule* units, const int32_t* keyed_us, uint16_t count, MorseDecoder* decoder) {
+    if(count > SCHEDULE_MAX_ELEMENTS) count = SCHEDULE_MAX_ELEMENTS;
+    units->count = count;
+    for(uint16_t i = 0; i < count; i++) {
+        int32_t element = keyed_us[i];
+        uint32_t duration_us = (uint32_t)(element > 0 ? element : -element);
+
+        // Classify against the estimate from before this element, as a listener would
+        if(element > 0) {
+            units->elements[i] = (duration_us >= 2 * decoder->dot_us) ? 3 : 1;
+            morse_decoder_mark(decoder, duration_us);
+        } else {
+            units->elements[i] = (duration_us >= 5 * decoder->dot_us) ? -7 :
+                                 (duration_us >= 2 * decoder->dot_us) ? -3 :
+                                                                        -1;
+            morse_decoder_space(decoder, duration_us);
+        }
+    }
+    morse_decoder_flush(decoder);
+
+    return (uint8_t)((1200000 + decoder->dot_us / 2) / decoder->dot_us);
+}
+
+int morse_confusion_record(MorseConfusion* confusion, char expected, char received, bool* halved) {
+    int row = get_table_index_for_char(expected);
+    *halved = false;
+    if(row < 0) return -1;
+
+    int column = get_table_index_for_char(received);
+    if(column < 0) column = CONFUSION_COLUMNS - 1;
+
+    uint8_t* counts = confusion->counts[row];
+    if(counts[column] == UINT8_MAX) {
+        for(int i = 0; i < CONFUSION_COLUMNS; i++) counts[i] /= 2;
+        *halved = true;
+    }
+    counts[column]++;
+    return row;
+}
+
+// Off-diagonal cells with the highest counts, highest first
+uint8_t morse_confusion_worst(const MorseConfusion* confusion, MorseConfusionPair* pairs, uint8_t max) {
+    uint8_t found = 0;
+
+    for(int row = 0; row < MORSE_TABLE_SIZE; row++) {
+        for(int column = 0; column < CONFUSION_COLUMNS; column++) {
+            uint8_t count = confusion->counts[row][column];
+            if(column == row || count == 0) continue;
+            if(found == max && count <= pairs[max - 1].count) continue;
+
+            // Insertion into the sorted list, dropping the last entry when full
+            uint8_t position = (found < max) ? found++ : max - 1;
+            while(position > 0 && pairs[position - 1].count < count) {
+                pairs[position] = pairs[position - 1];
+                position--;
+            }
+            pairs[position].expected = MORSE_TABLE[row].character;
+            pairs[position].received = (column < MORSE_TABLE_SIZE) ? MORSE_TABLE[column].character : MORSE_UNKNOWN;
+            pairs[position].count = count;
+        }
+    }
+
+    return found;
+}
+
+// Levenshtein distance over dots and dashes, one row of the table at a time
+static uint8_t code_distance(const char* a, const char* b) {
+    uint8_t row[DECODER_MAX_CODE + 1];
+    size_t b_length = strlen(b);
+    for(size_t j = 0; j <= b_length; j++) row[j] = (uint8_t)j;
+
+    for(size_t i = 0; a[i] != '\0'; i++) {
+        uint8_t diagonal = row[0];
+        row[0] = (uint8_t)(i + 1);
+        for(size_t j = 1; j <= b_length; j++) {
+            uint8_t above = row[j];
+            uint8_t best = diagonal + (a[i] != b[j - 1]);
+            if(above + 1 < best) best = above + 1;
+            if(row[j - 1] + 1 < best) best = row[j - 1] + 1;
+            row[j] = best;
+            diagonal = above;
+        }
+    }
+
+    return row[b_length];
+}
+
+static uint8_t shared_prefix(const char* a, const char* b) {
+    uint8_t length = 0;
+    while(a[length] != '\0' && a[length] == b[length]) length++;
+    return length;
+}
+
+void morse_similarity_init(MorseSimilarity* similarity) {
+    for(int row = 0; row < MORSE_TABLE_SIZE; row++) {
+        for(int column = row; column < MORSE_TABLE_SIZE; column++) {
+            uint8_t distance = code_distance(MORSE_TABLE[row].code, MORSE_TABLE[column].code);
+            similarity->distance[row][column] = distance;
+            similarity->distance[column][row] = distance;
+        }
+    }
+
+    // Keep the closest few per row: lower distance first, then longer shared prefix
+    for(int row = 0; row < MORSE_TABLE_SIZE; row++) {
+        const char* code = MORSE_TABLE[row].code;
+        uint8_t* neighbours = similarity->neighbours[row];
+        uint8_t found = 0;
+
+        for(int column = 0; column < MORSE_TABLE_SIZE; column++) {
+            if(column == row) continue;
+            uint8_t distance = similarity->distance[row][column];
+            uint8_t prefix = shared_prefix(code, MORSE_TABLE[column].code);
+
+            uint8_t position = found;
+            while(position > 0) {
+                uint8_t other = neighbours[position - 1];
+                uint8_t other_distance = similarity->distance[row][other];
+                if(other_distance < distance ||
+                   (other_distance == distance && shared_prefix(code, MORSE_TABLE[other].code) >= prefix)) {
+                    break;
+                }
+                if(position < SIMILAR_NEIGHBOURS) neighbours[position] = other;
+                position--;
+            }
+            if(position < SIMILAR_NEIGHBOURS) neighbours[position] = (uint8_t)column;
+            if(found < SIMILAR_NEIGHBOURS) found++;
+        }
+    }
+}
+
+#define PITCH_LOCK_RATIO 6.0f      // Strongest bin over the bank average before locking
+#define PITCH_RELOCK_RATIO 4.0f    // Another bin this much stronger takes the lock over
+#define PITCH_HOLD 0.9f            // Bin power decay per sweep
+#define PITCH_DRIFT_GAIN 0.05f     // Fraction of the measured offset corrected per block
+#define TONE_DC_SHIFT 2            // Bias and hum high-pass, corner near 150 Hz
+#define TONE_MIN_SNR 4.0f          // Peak over noise, in magnitude, before the key moves
+#define TONE_NOISE_FALL 0.05f      // Noise floor follows dips quickly...
+#define TONE_NOISE_RISE 0.005f     // ...and rises over a couple of seconds
+#define TONE_PEAK_DECAY 0.997f     // Signal level hold per block, about three seconds
+
+static float goertzel_coefficient(float frequency_hz) {
+    return 2.0f * cosf(6.2831853f * frequency_hz / TONE_SAMPLE_RATE);
+}
+
+// Power at one frequency over the window, oldest sample first
+static float goertzel_window(const MorseToneDetector* tone, float coefficient) {
+    float s1 = 0, s2 = 0;
+    uint16_t position = tone->window_position;
+    for(uint16_t i = 0; i < PITCH_WINDOW; i++) {
+        float s0 = tone->window[position] + coefficient * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+        if(++position == PITCH_WINDOW) position = 0;
+    }
+    return s1 * s1 + s2 * s2 - coefficient * s1 * s2;
+}
+
+static void tone_lock(MorseToneDetector* tone, float pitch_hz) {
+    if(pitch_hz < PITCH_MIN_HZ) pitch_hz = PITCH_MIN_HZ;
+    if(pitch_hz > PITCH_MAX_HZ) pitch_hz = PITCH_MAX_HZ;
+    tone->pitch_hz = pitch_hz;
+    tone->coefficient = goertzel_coefficient(pitch_hz);
+}
+
+// A sweep has finished: lock onto the strongest bin, refined between its neighbours
+static void tone_sweep_done(MorseToneDetector* tone) {
+    uint8_t best = 0;
+    float total = 0;
+    for(uint8_t b = 0; b < PITCH_BIN_COUNT; b++) {
+        total += tone->bin_power[b];
+        if(tone->bin_power[b] > tone->bin_power[best]) best = b;
+    }
+    float average = (total - tone->bin_power[best]) / (PITCH_BIN_COUNT - 1);
+
+    // A maximum at the band edge is leakage from outside, like mains hum
+    if(best == 0 || best == PITCH_BIN_COUNT - 1) return;
+    if(tone->bin_power[best] < PITCH_LOCK_RATIO * average) return;
+
+    float left = sqrtf(tone->bin_power[best - 1]);
+    float centre = sqrtf(tone->bin_power[best]);
+    float right = sqrtf(tone->bin_power[best + 1]);
+    float curvature = left - 2 * centre + right;
+    float offset = curvature < 0 ? 0.5f * (left - right) / curvature : 0;
+    float best_hz = PITCH_MIN_HZ + (best + offset) * PITCH_STEP_HZ;
+
+    if(tone->pitch_hz == 0) {
+        tone_lock(tone, best_hz);
+        return;
+    }
+
+    // Already locked: move only if a clearly stronger carrier shows up elsewhere
+    int locked = (int)((tone->pitch_hz - PITCH_MIN_HZ) / PITCH_STEP_HZ + 0.5f);
+    if(abs(locked - best) > 2 && tone->bin_power[best] > PITCH_RELOCK_RATIO * tone->bin_power[locked]) {
+        tone_lock(tone, best_hz);
+        tone->peak = tone->noise;
+    }
+}
+
+void morse_tone_init(MorseToneDetector* tone) {
+    memset(tone, 0, sizeof(MorseToneDetector));
+    tone->dc = -1;
+}
+
+bool morse_tone_process(MorseToneDetector* tone, const uint16_t* samples) {
+    // Remove the bias and append to the scan window. The bias starts at the
+    // first block's mean, so no step transient can lock the scan.
+    if(tone->dc < 0) {
+        uint32_t sum = 0;
+        for(uint16_t i = 0; i < TONE_BLOCK_SIZE; i++) sum += samples[i];
+        tone->dc = (float)sum / TONE_BLOCK_SIZE;
+    }
+    float s1 = 0, s2 = 0;
+    for(uint16_t i = 0; i < TONE_BLOCK_SIZE; i++) {
+        tone->dc += (samples[i] - tone->dc) / (1 << TONE_DC_SHIFT);
+        float sample = samples[i] - tone->dc;
+        tone->window[tone->window_position] = sample;
+        if(++tone->window_position == PITCH_WINDOW) tone->window_position = 0;
+
+        // Tone level over this block at the locked pitch
+        float s0 = sample + tone->coefficient * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+
+    // A fixed slice of the bank per block
+    for(uint8_t i = 0; i < PITCH_BINS_PER_BLOCK; i++) {
+        uint8_t b = tone->scan_bin;
+        float power = goertzel_window(tone, goertzel_coefficient(PITCH_MIN_HZ + b * PITCH_STEP_HZ));
+        float held = tone->bin_power[b] * PITCH_HOLD;
+        tone->bin_power[b] = power > held ? power : held;
+        if(++tone->scan_bin == PITCH_BIN_COUNT) {
+            tone->scan_bin = 0;
+            tone_sweep_done(tone);
+        }
+    }
+    if(tone->pitch_hz == 0) return false;
+
+    float power = s1 * s1 + s2 * s2 - tone->coefficient * s1 * s2;
+    tone->level = sqrtf(power > 0 ? power : 0);
+
+    // Envelope: the noise floor follows the quiet blocks, the peak holds the signal level
+    float decayed = tone->peak * TONE_PEAK_DECAY;
+    tone->peak = tone->level > decayed ? tone->level : decayed;
+    float span = tone->peak - tone->noise;
+    if(tone->level < tone->noise + 0.5f * span) {
+        float rate = tone->level < tone->noise ? TONE_NOISE_FALL : TONE_NOISE_RISE;
+        tone->noise += rate * (tone->level - tone->noise);
+    }
+    float threshold = tone->noise + (tone->key ? 0.35f : 0.5f) * span;
+    bool detected = tone->peak > TONE_MIN_SNR * tone->noise && tone->level > threshold;
+
+    // Two blocks in a row move the key, single-block noise hits are ignored
+    if(detected == tone->detected) tone->key = detected;
+    tone->detected = detected;
+
+    // While the key is down, steer toward the stronger side of the carrier
+    if(tone->key) {
+        float below = goertzel_window(tone, goertzel_coefficient(tone->pitch_hz - PITCH_STEP_HZ / 2.0f));
+        float above = goertzel_window(tone, goertzel_coefficient(tone->pitch_hz + PITCH_STEP_HZ / 2.0f));
+        if(below + above > 0) {
+            tone_lock(tone, tone->pitch_hz + PITCH_DRIFT_GAIN * PITCH_STEP_HZ * (above - below) / (above + below));
+        }
+    }
+
+    return tone->key;
+}
+
+// Bitwise, no table: only a few hundred bytes are checked at a time
+uint32_t morse_crc32(const void* data, size_t length) {
+    const uint8_t* bytes = data;
+    uint32_t crc = 0xFFFFFFFFu;
+    for(size_t i = 0; i < length; i++) {
+        crc ^= bytes[i];
+        for(int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
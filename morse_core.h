@@ -0,0 +1,228 @@
+#pragma once
+
+// Morse code tables, timing, keying schedules and decoding shared by the
+// Flipper app and the host tools in tools/. No Flipper SDK dependencies.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Speed limits (words per minute, PARIS timing)
+#define MIN_WPM 5
+#define MAX_WPM 60
+
+#define MORSE_TABLE_SIZE 53
+#define MORSE_UNKNOWN '*'          // Decoded from a code that is not in the table
+#define SCHEDULE_MAX_ELEMENTS 128  // Marks and spaces in one pre-encoded schedule
+#define DECODER_MAX_CODE 7         // Longest code the decoder collects before giving up
+#define GLITCH_DEFAULT_PERCENT 35  // Shortest valid mark or space, in percent of a dot
+
+// Confusion matrix: rows are the expected character, columns what came back
+#define CONFUSION_COLUMNS (MORSE_TABLE_SIZE + 1)  // Last column: no valid character
+
+#define SIMILAR_NEIGHBOURS 4       // Closest codes kept per character
+
+// Audio tone detection: a sliding Goertzel bank finds the carrier, then the
+// decoder follows it. Each block scans a fixed slice of the bank, a cosf per
+// bin; while locked with the key down it also runs two more 160-sample
+// windows to follow drift, so keyed blocks cost the most.
+#define TONE_SAMPLE_RATE 4000
+#define TONE_BLOCK_SIZE 32         // Samples per detection block, 8 ms
+#define PITCH_MIN_HZ 300
+#define PITCH_MAX_HZ 1200
+#define PITCH_STEP_HZ 25
+#define PITCH_BIN_COUNT ((PITCH_MAX_HZ - PITCH_MIN_HZ) / PITCH_STEP_HZ + 1)
+#define PITCH_WINDOW 160           // Scan window, 25 Hz resolution at 4 kHz
+#define PITCH_BINS_PER_BLOCK 4     // Bank bins evaluated per block, a sweep takes 10 blocks
+
+// Morse code structure
+typedef struct {
+    char character;
+    const char* code;
+} MorseCode;
+
+// Character sets as bitmasks over table indices: bit i is MORSE_TABLE[i].
+// Prosigns are written as the punctuation sharing their code, and SK as '>'.
+typedef uint64_t MorseCharset;
+
+#define MORSE_CHARSET_BIT(index) ((MorseCharset)1 << (index))
+#define MORSE_CHARSET_LETTERS 0x0000000003FFFFFFull      // A-Z
+#define MORSE_CHARSET_DIGITS 0x0000000FFC000000ull       // 0-9
+#define MORSE_CHARSET_PUNCTUATION 0x000FFFF000000000ull  // . , ? ' ! / ( ) & : ; = + - " @
+#define MORSE_CHARSET_PROSIGNS 0x0011940000000000ull     // KN AS BT AR SK
+#define MORSE_CHARSET_ALL (MORSE_CHARSET_BIT(MORSE_TABLE_SIZE) - 1)
+
+_Static_assert(MORSE_TABLE_SIZE <= 64, "MorseCharset holds one bit per table entry");
+
+// xoshiro128** generator state, small and fast on Cortex-M4 (no 64-bit math)
+typedef struct {
+    uint32_t s[4];
+} MorseRng;
+
+// Pre-encoded keying: >0 key down, <0 key up, in ms (or dot units before scaling)
+typedef struct {
+    uint16_t count;
+    int16_t elements[SCHEDULE_MAX_ELEMENTS];
+} MorseSchedule;
+
+// Adaptive timing decoder, fed with mark and space durations in microseconds
+typedef void (*MorseDecoderCallback)(char character, void* context);
+
+typedef struct {
+    uint32_t dot_us;                    // Running estimate of one dot
+    char code[DECODER_MAX_CODE + 1];
+    uint8_t code_length;
+    bool overflow;                      // More elements than any code has
+    MorseDecoderCallback callback;
+    void* context;
+} MorseDecoder;
+
+// Front end of the decoder for raw key edges. A mark or space shorter than
+// percent of the decoder's current dot is a spike or contact bounce: it is
+// merged into the run before it, and the run after it joins the same run.
+// One run is held back until the next edge shows whether it continues.
+typedef struct {
+    MorseDecoder* decoder;
+    uint8_t percent;                    // 0 passes every run straight through
+    bool pending;
+    bool pending_down;
+    uint32_t pending_us;
+    uint32_t suppressed;                // Glitches merged away
+} MorseGlitchFilter;
+
+// Pitch scan, carrier tracking and key envelope over raw ADC blocks
+typedef struct {
+    float dc;                           // Input bias, removed before detection
+    float window[PITCH_WINDOW];         // Recent samples, ring
+    uint16_t window_position;
+    float bin_power[PITCH_BIN_COUNT];   // Peak-held power of each bank bin
+    uint8_t scan_bin;                   // Next bin to evaluate
+    float pitch_hz;                     // Locked carrier, 0 while searching
+    float coefficient;                  // Goertzel coefficient of pitch_hz
+    float level;                        // Tone magnitude of the last block
+    float noise;
+    float peak;
+    bool detected;                      // Previous block's raw detection
+    bool key;
+} MorseToneDetector;
+
+// Saturating expected-versus-received counters; a row is halved instead of
+// overflowing, so the ratios within it survive
+typedef struct {
+    uint8_t counts[MORSE_TABLE_SIZE][CONFUSION_COLUMNS];
+} MorseConfusion;
+
+typedef struct {
+    char expected;
+    char received;                      // MORSE_UNKNOWN for an invalid code
+    uint8_t count;
+} MorseConfusionPair;
+
+// Element-level edit distances between all codes, built once. neighbours lists
+// the closest codes of each character by table index, ties broken by the
+// longer shared prefix, so a drill picks a confusable partner by lookup.
+typedef struct {
+    uint8_t distance[MORSE_TABLE_SIZE][MORSE_TABLE_SIZE];
+    uint8_t neighbours[MORSE_TABLE_SIZE][SIMILAR_NEIGHBOURS];
+} MorseSimilarity;
+
+extern const MorseCode MORSE_TABLE[];
+
+// Table lookups
+int get_table_index_for_char(char c);
+const char* get_morse_for_char(char c);
+char get_char_for_morse(const char* morse);
+
+// Character sets, O(1) apart from building one from text
+int morse_charset_next(MorseCharset set, int index);
+int morse_charset_previous(MorseCharset set, int index);
+uint8_t morse_charset_count(MorseCharset set);
+int morse_charset_select(MorseCharset set, uint8_t rank);
+int morse_charset_sample(MorseCharset set, MorseRng* rng);
+MorseCharset morse_charset_from_text(const char* text);
+
+// Name of the prosign a table character stands for ("SK" for '>'), NULL if none
+const char* morse_prosign_name(char character);
+
+// Seedable PRNG, the same seed always yields the same sequence
+void morse_rng_seed(MorseRng* rng, uint32_t seed);
+uint32_t morse_rng_next(MorseRng* rng);
+uint32_t morse_rng_range(MorseRng* rng, uint32_t n);
+
+// Keying schedules
+uint16_t morse_unit_ms(uint8_t wpm);
+bool encode_units(MorseSchedule* schedule, const char* text);
+void schedule_units_to_ms(MorseSchedule* schedule, uint8_t wpm);
+bool encode_schedule(MorseSchedule* schedule, const char* text, uint8_t wpm);
+
+// Timing decoder
+void morse_decoder_init(MorseDecoder* decoder, uint8_t wpm, MorseDecoderCallback callback, void* context);
+void morse_decoder_mark(MorseDecoder* decoder, uint32_t duration_us);
+void morse_decoder_space(MorseDecoder* decoder, uint32_t duration_us);
+void morse_decoder_flush(MorseDecoder* decoder);
+
+// Glitch filter, O(1) per run; flush hands over the held run
+void morse_filter_init(MorseGlitchFilter* filter, MorseDecoder* decoder, uint8_t percent);
+void morse_filter_run(MorseGlitchFilter* filter, bool key_down, uint32_t duration_us);
+void morse_filter_flush(MorseGlitchFilter* filter);
+
+// Quantise keyed timing in signed us to dot units, marks and spaces classified
+// by the decoder as it adapts (characters reach its callback); returns the
+// final speed
+uint8_t morse_quantise_schedule(MorseSchedule* units, const int32_t* keyed_us, uint16_t count, MorseDecoder* decoder);
+
+// Confusion matrix. record returns the updated row, or -1 if expected is not in
+// the table; *halved is set when the whole row was scaled down.
+int morse_confusion_record(MorseConfusion* confusion, char expected, char received, bool* halved);
+uint8_t morse_confusion_worst(const MorseConfusion* confusion, MorseConfusionPair* pairs, uint8_t max);
+
+// Code similarity
+void morse_similarity_init(MorseSimilarity* similarity);
+
+// Tone detector, fed TONE_BLOCK_SIZE samples at TONE_SAMPLE_RATE; returns the key state
+void morse_tone_init(MorseToneDetector* tone);
+bool morse_tone_process(MorseToneDetector* tone, const uint16_t* samples);
+
+// CRC-32 (IEEE, as zlib) of saved records
+uint32_t morse_crc32(const void* data, size_t length);
+
+// Lesson pack (.mlp), little-endian. The index sits right after the header so
+// any lesson is one seek away; drills are stored pre-encoded in dot units.
+//   LessonPackHeader
+//   LessonIndexEntry[lesson_count]
+//   per lesson: LessonHeader, then drill_count x
+//       (LessonDrillHeader, text[text_length], int8_t elements[element_count])
+#define LESSON_PACK_MAGIC "MMLP"
+#define LESSON_PACK_VERSION 1
+#define LESSON_TITLE_MAX 16        // Fixed width, NUL padded, not terminated when full
+#define LESSON_CHARS_MAX 8
+#define LESSON_TEXT_MAX 64         // Longest drill text
+
+typedef struct {
+    char magic[4];
+    uint16_t version;
+    uint16_t lesson_count;
+} LessonPackHeader;
+
+typedef struct {
+    uint32_t offset;               // Of the LessonHeader from the start of the file
+    uint32_t size;                 // Bytes of the lesson including its header
+    char title[LESSON_TITLE_MAX];
+} LessonIndexEntry;
+
+typedef struct {
+    char new_chars[LESSON_CHARS_MAX];   // Characters introduced by the lesson
+    uint8_t target_wpm;
+    uint8_t pass_percent;               // Copy accuracy needed to pass
+    uint16_t drill_count;
+} LessonHeader;
+
+typedef struct {
+    uint16_t text_length;
+    uint16_t element_count;
+} LessonDrillHeader;
+
+_Static_assert(sizeof(LessonPackHeader) == 8, "LessonPackHeader layout");
+_Static_assert(sizeof(LessonIndexEntry) == 24, "LessonIndexEntry layout");
+_Static_assert(sizeof(LessonHeader) == 12, "LessonHeader layout");
+_Static_assert(sizeof(LessonDrillHeader) == 4, "LessonDrillHeader layout");
@@ -0,0 +1,15 @@
+#include "morse_gloss.h"
+
+#include <string.h>
+
+#include "morse_gloss_table.h"
+
+// The word picks a bucket, the bucket's seed picks the slot; a word that is
+// not in the table still lands on some slot, so the compare decides
+const MorseGloss* morse_gloss_lookup(const char* word, size_t length) {
+    if(length == 0 || length > GLOSS_WORD_MAX) return NULL;
+
+    uint32_t seed = GLOSS_SEEDS[morse_gloss_hash(word, length, 0) % GLOSS_BUCKETS];
+    const MorseGloss* entry = &GLOSS_TABLE[morse_gloss_hash(word, length, seed) % GLOSS_COUNT];
+    return (strncmp(entry->word, word, length) == 0 && entry->word[length] == '\0') ? entry : NULL;
+}
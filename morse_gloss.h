@@ -0,0 +1,30 @@
+#pragma once
+
+// Transcript glossary: prosigns, Q-codes and operating abbreviations with a
+// short meaning. The table in morse_gloss_table.h is a minimal perfect hash
+// generated by tools/morse_gloss, so a lookup is two hashes, one seed read and
+// one compare, straight from flash. No Flipper SDK dependencies.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define GLOSS_MEANING_MAX 18       // Fits one line of the Listen screen
+
+typedef struct {
+    const char* word;
+    const char* meaning;
+} MorseGloss;
+
+// FNV-1a from a seeded start, with a final mix so nearby seeds spread words
+// apart. Shared with the generator, which must place words the same way.
+static inline uint32_t morse_gloss_hash(const char* word, size_t length, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+    for(size_t i = 0; i < length; i++) hash = (hash ^ (uint8_t)word[i]) * 16777619u;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+// Entry for a whole decoded word (upper case, not terminated), NULL if none
+const MorseGloss* morse_gloss_lookup(const char* word, size_t length);
@@ -0,0 +1,275 @@
+#pragma once
+
+// Generated by tools/morse_gloss from tools/gloss.txt; edit that and run
+// `make gloss` in tools/. Included by morse_gloss.c only.
+
+#define GLOSS_COUNT 255
+#define GLOSS_BUCKETS 64
+#define GLOSS_WORD_MAX 8
+
+static const uint16_t GLOSS_SEEDS[GLOSS_BUCKETS] = {
+    8, 1, 3, 15, 24, 3, 5, 17, 139, 43, 7, 1,
+    65, 2, 9, 2, 11, 8, 268, 62, 45, 30, 114, 1,
+    108, 2, 143, 118, 59, 22, 1, 18, 9, 340, 257, 284,
+    368, 160, 668, 78, 6, 21, 8, 396, 38, 758, 189, 0,
+    24, 10, 699, 39, 2483, 120, 1, 10587, 1, 6, 22, 3,
+    45, 1, 25, 0,
+};
+
+static const MorseGloss GLOSS_TABLE[GLOSS_COUNT] = {
+    {"BCI", "broadcast interf."},
+    {"WAS", "Worked All States"},
+    {"QNI", "net check-in"},
+    {"QRA", "station name"},
+    {"RCVR", "receiver"},
+    {"SFR", "so far"},
+    {"U", "you"},
+    {"UFB", "ultra fine"},
+    {"YAGI", "beam antenna"},
+    {"GA", "good afternoon"},
+    {"CONDX", "conditions"},
+    {"DXCC", "DX Century Club"},
+    {"559", "fair report"},
+    {"AMP", "amplifier"},
+    {"CPI", "copy"},
+    {"TXT", "text"},
+    {"BTU", "back to you"},
+    {"TIL", "until"},
+    {"OB", "old boy"},
+    {"STN", "station"},
+    {"SUM", "some"},
+    {"QST", "to all amateurs"},
+    {"XTAL", "crystal"},
+    {"73", "best regards"},
+    {"STBY", "stand by"},
+    {"LOOP", "loop antenna"},
+    {"TU", "thank you"},
+    {"SSB", "single sideband"},
+    {"R", "received, roger"},
+    {"AS", "wait"},
+    {"OSC", "oscillator"},
+    {"OT", "old timer"},
+    {"TEST", "contest"},
+    {"&", "wait"},
+    {"DSW", "goodbye"},
+    {"WKD", "worked"},
+    {"LOTW", "Logbook of World"},
+    {"OK", "okay"},
+    {"FONE", "phone"},
+    {"HW", "how copy?"},
+    {"HPE", "hope"},
+    {"DN", "down"},
+    {"?", "say again"},
+    {"BURO", "QSL bureau"},
+    {"NR", "number, near"},
+    {"CUAGN", "see you again"},
+    {"QTC", "messages to send"},
+    {"LSN", "listen"},
+    {"VFO", "tuning oscillator"},
+    {"QTA", "cancel message"},
+    {"TRX", "transceiver"},
+    {"WB", "word before"},
+    {"NIL", "nothing"},
+    {"88", "love and kisses"},
+    {"SKCC", "Straight Key Club"},
+    {"WRK", "work"},
+    {"ADR", "address"},
+    {"+", "end of message"},
+    {"GE", "good evening"},
+    {"QTH", "location"},
+    {"K", "over"},
+    {"KN", "over, named only"},
+    {"(", "over, named only"},
+    {"RFI", "RF interference"},
+    {"QTR", "exact time"},
+    {"55", "good luck"},
+    {"QRO", "more power"},
+    {"WID", "with"},
+    {"EVE", "evening"},
+    {"QSU", "reply here"},
+    {"SED", "said"},
+    {"DE", "from, this is"},
+    {"HAM", "amateur"},
+    {"GD", "good day"},
+    {"BTW", "by the way"},
+    {"PLS", "please"},
+    {"RTN", "return"},
+    {"BK", "break"},
+    {"QSM", "repeat last"},
+    {"=", "break"},
+    {"IOTA", "Islands on the Air"},
+    {"QRK", "readability"},
+    {"TNX", "thanks"},
+    {"BT", "break"},
+    {"QSW", "will send on"},
+    {"SEZ", "says"},
+    {"LW", "long wire"},
+    {"HR", "here, hear"},
+    {"QSV", "send test Vs"},
+    {"LP", "long path"},
+    {"QSO", "contact"},
+    {"ANT", "antenna"},
+    {"SN", "soon"},
+    {"XYL", "wife"},
+    {"SOTA", "Summits on Air"},
+    {"AR", "end of message"},
+    {"QSK", "break-in"},
+    {"BIZ", "business"},
+    {"URS", "yours"},
+    {"PWR", "power"},
+    {"LOC", "locator"},
+    {"N", "no, nine"},
+    {"GM", "good morning"},
+    {"GRID", "locator"},
+    {"GG", "going"},
+    {"W", "watts"},
+    {"AM", "morning / AM mode"},
+    {"WA", "word after"},
+    {"UTC", "world time"},
+    {"QRU", "nothing for you"},
+    {"VERT", "vertical antenna"},
+    {"ATU", "antenna tuner"},
+    {"RPT", "repeat, report"},
+    {"PA", "power amplifier"},
+    {"BN", "been"},
+    {"SP", "short path"},
+    {"BD", "bad"},
+    {"BEAM", "beam antenna"},
+    {"TX", "transmitter"},
+    {"WAT", "what"},
+    {"QRB", "distance"},
+    {"GP", "ground plane"},
+    {"579", "good report"},
+    {"QSB", "fading"},
+    {"QSN", "heard you"},
+    {"FB", "fine business"},
+    {"EU", "Europe"},
+    {"QRT", "closing down"},
+    {"WX", "weather"},
+    {"PSE", "please"},
+    {"QRS", "send slower"},
+    {"CPY", "copy"},
+    {"POTA", "Parks on the Air"},
+    {"BTR", "better"},
+    {"GB", "goodbye"},
+    {"NW", "now"},
+    {"QRJ", "signals weak"},
+    {"WD", "word"},
+    {"QSY", "change frequency"},
+    {"RST", "signal report"},
+    {"CS", "callsign"},
+    {"QRG", "exact frequency"},
+    {"HI", "laughter"},
+    {"RCD", "received"},
+    {"TVI", "TV interference"},
+    {"LID", "poor operator"},
+    {"GND", "ground"},
+    {"AGN", "again"},
+    {"C", "yes, correct"},
+    {"TT", "that"},
+    {"WL", "will, well"},
+    {"QSL", "confirmed"},
+    {"YL", "young lady"},
+    {"B4", "before"},
+    {"SIGS", "signals"},
+    {"TMW", "tomorrow"},
+    {"BCNU", "be seeing you"},
+    {"CK", "check"},
+    {"HV", "have"},
+    {"SWR", "standing wave"},
+    {"NAME", "name is"},
+    {"QSZ", "send words twice"},
+    {"QRL", "frequency in use?"},
+    {"SKED", "schedule"},
+    {">", "end of contact"},
+    {"SGD", "signed"},
+    {"339", "weak report"},
+    {"DX", "long distance"},
+    {"XMAS", "Christmas"},
+    {"EL", "elements"},
+    {"QRN", "static"},
+    {"DR", "dear"},
+    {"LIS", "licensed"},
+    {"FER", "for"},
+    {"SVC", "service"},
+    {"XMTR", "transmitter"},
+    {"LTR", "later, letter"},
+    {"PSED", "pleased"},
+    {"CONGRATS", "congratulations"},
+    {"GUD", "good"},
+    {"CFM", "confirm"},
+    {"QTX", "keep station open"},
+    {"MTR", "meter"},
+    {"QRH", "frequency varies"},
+    {"SIG", "signal"},
+    {"NM", "no more"},
+    {"RIG", "equipment"},
+    {"599", "perfect report"},
+    {"WDS", "words"},
+    {"QRZ", "who is calling?"},
+    {"RPRT", "report"},
+    {"VY", "very"},
+    {"GL", "good luck"},
+    {"NBR", "number"},
+    {"WRD", "word"},
+    {"QRV", "ready"},
+    {"RE", "concerning"},
+    {"EFHW", "end-fed half-wave"},
+    {"GMT", "UTC"},
+    {"ELBUG", "electronic key"},
+    {"OM", "old man"},
+    {"PX", "prefix"},
+    {"WUD", "would"},
+    {"5NN", "report 599"},
+    {"CUD", "could"},
+    {"OP", "operator"},
+    {"YRS", "years"},
+    {"SK", "end of contact"},
+    {"OC", "old chap"},
+    {"QRW", "tell them I call"},
+    {"MSG", "message"},
+    {"SOLID", "solid copy"},
+    {"ABT", "about"},
+    {"QSX", "listening on"},
+    {"TFC", "traffic"},
+    {"QRI", "tone"},
+    {"UR", "your, you are"},
+    {"OPR", "operator"},
+    {"GN", "good night"},
+    {"QRP", "low power"},
+    {"CL", "closing station"},
+    {"72", "best QRP regards"},
+    {"WPM", "words per minute"},
+    {"FWD", "forward"},
+    {"TKS", "thanks"},
+    {"161", "73 and 88"},
+    {"QRQ", "send faster"},
+    {"WKG", "working"},
+    {"QRX", "stand by"},
+    {"RTTY", "radioteletype"},
+    {"HRD", "heard"},
+    {"CLG", "calling"},
+    {"FM", "from / FM mode"},
+    {"CW", "Morse code"},
+    {"AA", "all after"},
+    {"INFO", "information"},
+    {"QRM", "interference"},
+    {"SRI", "sorry"},
+    {"QRPP", "very low power"},
+    {"YR", "year, your"},
+    {"BUG", "semi-auto key"},
+    {"XCVR", "transceiver"},
+    {"PKT", "packet"},
+    {"QSA", "signal strength"},
+    {"QSP", "relay"},
+    {"AB", "all before"},
+    {"MNI", "many"},
+    {"CQ", "calling anyone"},
+    {"CUL", "see you later"},
+    {"FREQ", "frequency"},
+    {"RX", "receiver"},
+    {"30", "end of message"},
+    {"ES", "and"},
+    {"RCVD", "received"},
+    {"QSD", "keying defective"},
+};
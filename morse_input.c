@@ -0,0 +1,286 @@
+#include "morse_input.h"
+
+#include <furi.h>
+#include <furi_hal.h>
+#include <gui/elements.h>
+#include <input/input.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEXT_WIDTH 124             // Pixels of text shown, the tail scrolls in from the right
+
+typedef struct {
+    char header[MORSE_INPUT_HEADER_MAX + 1];
+    char text[MORSE_INPUT_TEXT_MAX + 1];
+    uint8_t text_length;
+    char code[DECODER_MAX_CODE + 1];
+    uint8_t code_length;
+    bool key_down;
+} MorseInputModel;
+
+struct MorseInput {
+    View* view;
+    FuriTimer* char_timer;         // Pause that ends a character
+    FuriTimer* word_timer;         // Longer pause that ends a word
+    uint32_t char_gap_ms;
+    uint32_t word_gap_ms;
+    float sidetone;
+    MorseInputCallback callback;
+    void* context;
+};
+
+// Appends to the text, false when it is full or the character is a repeat space
+static bool append(MorseInputModel* model, char character) {
+    if(model->text_length == MORSE_INPUT_TEXT_MAX) return false;
+    if(character == ' ' && (model->text_length == 0 || model->text[model->text_length - 1] == ' ')) {
+        return false;
+    }
+    model->text[model->text_length++] = character;
+    model->text[model->text_length] = '\0';
+    return true;
+}
+
+static void notify(MorseInput* input, char character) {
+    if(input->callback) input->callback(character, input->context);
+}
+
+static void char_timer_callback(void* context) {
+    MorseInput* input = context;
+    char character = '\0';
+    with_view_model(
+        input->view,
+        MorseInputModel * model,
+        {
+            if(model->code_length > 0) {
+                char decoded = get_char_for_morse(model->code);
+                if(append(model, decoded ? decoded : MORSE_UNKNOWN)) character = model->text[model->text_length - 1];
+                model->code_length = 0;
+                model->code[0] = '\0';
+            }
+        },
+        true);
+    if(character) notify(input, character);
+}
+
+static void word_timer_callback(void* context) {
+    MorseInput* input = context;
+    bool added = false;
+    with_view_model(
+        input->view,
+        MorseInputModel * model,
+        { if(model->code_length == 0) added = append(model, ' '); },
+        true);
+    if(added) notify(input, ' ');
+}
+
+static void sidetone_start(MorseInput* input) {
+    if(input->sidetone > 0 && furi_hal_speaker_acquire(0)) {
+        furi_hal_speaker_start(MORSE_INPUT_SIDETONE_HZ, input->sidetone);
+    }
+}
+
+static void sidetone_stop(void) {
+    if(furi_hal_speaker_is_mine()) {
+        furi_hal_speaker_stop();
+        furi_hal_speaker_release();
+    }
+}
+
+static void stop_timers(MorseInput* input) {
+    furi_timer_stop(input->char_timer);
+    furi_timer_stop(input->word_timer);
+}
+
+// Elements land on the Short/Long event like Practice; the gaps count from
+// the release, so a held dash never runs into the pause
+static bool key_ok(MorseInput* input, InputType type) {
+    if(type == InputTypePress) {
+        stop_timers(input);
+        sidetone_start(input);
+        with_view_model(input->view, MorseInputModel * model, { model->key_down = true; }, true);
+    } else if(type == InputTypeShort || type == InputTypeLong) {
+        with_view_model(
+            input->view,
+            MorseInputModel * model,
+            {
+                if(model->code_length < DECODER_MAX_CODE) {
+                    model->code[model->code_length++] = (type == InputTypeShort) ? '.' : '-';
+                    model->code[model->code_length] = '\0';
+                }
+            },
+            true);
+    } else if(type == InputTypeRelease) {
+        sidetone_stop();
+        with_view_model(input->view, MorseInputModel * model, { model->key_down = false; }, true);
+        furi_timer_start(input->char_timer, furi_ms_to_ticks(input->char_gap_ms));
+        if(input->word_gap_ms > input->char_gap_ms) {
+            furi_timer_start(input->word_timer, furi_ms_to_ticks(input->word_gap_ms));
+        }
+    }
+    return true;
+}
+
+// LEFT drops a half-keyed character first, then the last one in the text
+static bool key_left(MorseInput* input, InputType type) {
+    if(type != InputTypeShort && type != InputTypeLong) return true;
+    stop_timers(input);
+    uint8_t removed = 0;
+    with_view_model(
+        input->view,
+        MorseInputModel * model,
+        {
+            if(model->code_length > 0) {
+                model->code_length = 0;
+                model->code[0] = '\0';
+            } else if(type == InputTypeLong) {
+                removed = model->text_length;
+                model->text_length = 0;
+            } else if(model->text_length > 0) {
+                removed = 1;
+                model->text_length--;
+            }
+            model->text[model->text_length] = '\0';
+        },
+        true);
+    while(removed--) notify(input, '\b');
+    return true;
+}
+
+static bool key_right(MorseInput* input, InputType type) {
+    if(type != InputTypeShort) return true;
+    // Settle a half-keyed character before the space goes after it
+    if(furi_timer_is_running(input->char_timer)) {
+        furi_timer_stop(input->char_timer);
+        char_timer_callback(input);
+    }
+    furi_timer_stop(input->word_timer);
+    word_timer_callback(input);
+    return true;
+}
+
+static bool morse_input_input_callback(InputEvent* event, void* context) {
+    MorseInput* input = context;
+    switch(event->key) {
+    case InputKeyOk:
+        return key_ok(input, event->type);
+    case InputKeyLeft:
+        return key_left(input, event->type);
+    case InputKeyRight:
+        return key_right(input, event->type);
+    default:
+        return false;
+    }
+}
+
+static void morse_input_draw_callback(Canvas* canvas, void* context) {
+    MorseInputModel* model = context;
+    canvas_clear(canvas);
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str(canvas, 2, 10, model->header);
+
+    // Tail of the text that fits, with a cursor after it
+    char line[MORSE_INPUT_TEXT_MAX + 2];
+    snprintf(line, sizeof(line), "%s_", model->text);
+    canvas_set_font(canvas, FontSecondary);
+    const char* shown = line;
+    while(shown[1] && canvas_string_width(canvas, shown) > TEXT_WIDTH) shown++;
+    canvas_draw_str(canvas, 2, 24, shown);
+
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 42, AlignCenter, AlignBottom, model->code);
+    if(model->key_down) canvas_draw_disc(canvas, 120, 37, 3);
+
+    canvas_set_font(canvas, FontSecondary);
+    canvas_draw_str_aligned(canvas, 64, 62, AlignCenter, AlignBottom, "OK key  < del  > space");
+}
+
+MorseInput* morse_input_alloc(void) {
+    MorseInput* input = malloc(sizeof(MorseInput));
+    memset(input, 0, sizeof(MorseInput));
+    input->char_gap_ms = MORSE_INPUT_CHAR_GAP_MS;
+
+    input->view = view_alloc();
+    view_set_context(input->view, input);
+    view_allocate_model(input->view, ViewModelTypeLocking, sizeof(MorseInputModel));
+    view_set_draw_callback(input->view, morse_input_draw_callback);
+    view_set_input_callback(input->view, morse_input_input_callback);
+
+    input->char_timer = furi_timer_alloc(char_timer_callback, FuriTimerTypeOnce, input);
+    input->word_timer = furi_timer_alloc(word_timer_callback, FuriTimerTypeOnce, input);
+
+    morse_input_set_header(input, NULL);
+    morse_input_reset(input);
+    return input;
+}
+
+void morse_input_free(MorseInput* input) {
+    furi_assert(input);
+    stop_timers(input);
+    furi_timer_free(input->char_timer);
+    furi_timer_free(input->word_timer);
+    sidetone_stop();
+    view_free(input->view);
+    free(input);
+}
+
+View* morse_input_get_view(MorseInput* input) {
+    furi_assert(input);
+    return input->view;
+}
+
+void morse_input_set_callback(MorseInput* input, MorseInputCallback callback, void* context) {
+    furi_assert(input);
+    input->callback = callback;
+    input->context = context;
+}
+
+void morse_input_set_header(MorseInput* input, const char* header) {
+    furi_assert(input);
+    with_view_model(
+        input->view,
+        MorseInputModel * model,
+        { snprintf(model->header, sizeof(model->header), "%s", header ? header : ""); },
+        true);
+}
+
+void morse_input_set_gaps(MorseInput* input, uint32_t char_gap_ms, uint32_t word_gap_ms) {
+    furi_assert(input);
+    input->char_gap_ms = char_gap_ms ? char_gap_ms : MORSE_INPUT_CHAR_GAP_MS;
+    input->word_gap_ms = word_gap_ms;
+}
+
+void morse_input_set_sidetone(MorseInput* input, float volume) {
+    furi_assert(input);
+    input->sidetone = volume;
+}
+
+void morse_input_reset(MorseInput* input) {
+    furi_assert(input);
+    stop_timers(input);
+    with_view_model(
+        input->view,
+        MorseInputModel * model,
+        {
+            model->text_length = 0;
+            model->text[0] = '\0';
+            model->code_length = 0;
+            model->code[0] = '\0';
+            model->key_down = false;
+        },
+        true);
+}
+
+size_t morse_input_get_text(MorseInput* input, char* text, size_t size) {
+    furi_assert(input);
+    size_t length = 0;
+    with_view_model(
+        input->view,
+        MorseInputModel * model,
+        {
+            length = model->text_length;
+            if(size > 0) snprintf(text, size, "%s", model->text);
+        },
+        false);
+    return length;
+}
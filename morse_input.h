@@ -0,0 +1,49 @@
+#pragma once
+
+// Morse text entry as a View, for any app that wants Morse as an input
+// method. OK is the key the way Practice keys it: a short press is a dot, a
+// long press a dash. A pause ends the character and decoded text comes back
+// through the callback. Memory is fixed when the view is allocated and the
+// gaps run on FuriTimers, so the host only adds the view to its dispatcher.
+//
+// Keys: OK dot/dash, LEFT deletes, RIGHT adds a space, LEFT long clears.
+// BACK and UP/DOWN are left to the host (BACK through the navigation
+// callback, UP/DOWN through the previous/next view, if it sets any).
+//
+// Needs morse_core.c/.h alongside; no other files from this app.
+
+#include <gui/view.h>
+
+#include "morse_core.h"
+
+#define MORSE_INPUT_TEXT_MAX 64           // Characters kept, further ones are refused
+#define MORSE_INPUT_HEADER_MAX 24
+#define MORSE_INPUT_CHAR_GAP_MS 2000      // Same pause Practice decodes after
+#define MORSE_INPUT_SIDETONE_HZ 700.0f
+
+typedef struct MorseInput MorseInput;
+
+// Called with each character added to the text, ' ' included, and with '\b'
+// for a delete. Runs on the timer thread after a pause, or the GUI thread
+// for a key, so keep it short: queue a custom event rather than switch view.
+typedef void (*MorseInputCallback)(char character, void* context);
+
+MorseInput* morse_input_alloc(void);
+void morse_input_free(MorseInput* input);
+View* morse_input_get_view(MorseInput* input);
+
+void morse_input_set_callback(MorseInput* input, MorseInputCallback callback, void* context);
+void morse_input_set_header(MorseInput* input, const char* header);
+
+// Pause that ends a character, and the longer one that also ends a word;
+// a word gap of 0 leaves spaces to RIGHT
+void morse_input_set_gaps(MorseInput* input, uint32_t char_gap_ms, uint32_t word_gap_ms);
+
+// Tone while OK is held, 0 for silent (the default)
+void morse_input_set_sidetone(MorseInput* input, float volume);
+
+// Empties the text and any half-keyed character
+void morse_input_reset(MorseInput* input);
+
+// Copies the text, always terminated; returns its length
+size_t morse_input_get_text(MorseInput* input, char* text, size_t size);
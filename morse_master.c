@@ -6,11 +6,21 @@
 #include <furi_hal.h>
 #include <furi_hal_rtc.h>
 #include <furi_hal_speaker.h>
+#include <furi_hal_bus.h>
+#include <furi_hal_interrupt.h>
+#include <stm32wbxx_ll_tim.h>
+#include <stm32wbxx_ll_adc.h>
+#include <storage/storage.h>
+#include <toolbox/version.h>
 #include <string.h>
 #include <ctype.h>
 
 // Include icons
 #include "morse_master_icons.h"
+#include "morse_core.h"
+#include "morse_adif.h"
+#include "morse_gloss.h"
+#include "morse_clock.h"
 
 // Timing Configuration (in milliseconds)
 #define DOT_DURATION_MS 150
@@ -23,6 +33,169 @@
 #define TOP_WORDS_MAX_LENGTH 16    // Maximum length for top words marquee display
 #define INITIAL_VOLUME 0.25f      // Initial volume level (0.0 to 1.0)
 #define DEFAULT_FREQUENCY 800
+#define INPUT_QUEUE_SIZE 16        // Key events waiting for the main loop, a press, short and release each
+
+// Code glyph rendering: one row per code, sized to the panel it is drawn in
+#define GLYPH_LEARN_WIDTH 31       // Right page of the Learn book
+#define GLYPH_PRACTICE_WIDTH 31    // Across the Practice ball
+#define GLYPH_ECHO_WIDTH 80        // Echo board
+#define GLYPH_MAX_WIDTH GLYPH_ECHO_WIDTH
+#define GLYPH_MAX_HEIGHT 5         // Largest dot plus one
+#define GLYPH_MAX_STRIDE ((GLYPH_MAX_WIDTH + 7) / 8)
+#define RNG_BENCHMARK_ROUNDS 100000  // Draws per generator in the debug-mode PRNG benchmark
+
+// Fox hunt
+#define FOX_MIN_FOXES 2
+#define FOX_MAX_FOXES 5            // Cycle lengths must divide a day (1440 minutes)
+#define FOX_DEFAULT_WPM 12
+#define FOX_SLOT_SECONDS 60        // Each fox keys for one minute of the cycle
+#define FOX_SLOT_GUARD_MS 1500     // Stop keying this long before the slot ends
+#define FOX_ALIGN_WINDOW_S 1       // Sleep until this close to the slot, then watch the RTC second
+#define FOX_FLAG_STOP (1 << 0)
+#define FOX_KEY_PIN gpio_ext_pb2   // GPIO 6, high while the key is down
+
+// Max copy speed ladder
+#define LADDER_CHARSET (MORSE_CHARSET_LETTERS | MORSE_CHARSET_DIGITS)
+#define LADDER_GROUP_SIZE 5        // Characters per calibrated group
+#define LADDER_GROUPS_PER_STEP 3   // Groups pre-encoded for each speed step
+#define LADDER_COPIES_TO_PASS 2    // Groups copied at one speed before it counts and the test steps up
+#define LADDER_DEFAULT_BASE_WPM 15
+#define LADDER_DEFAULT_STEP_WPM 2
+#define LADDER_DEFAULT_MISSES 3
+#define LADDER_MAX_MISSES 9
+#define LADDER_MAX_STEP_WPM 5
+#define LADDER_HISTORY_SHOWN 3     // Most recent results shown on the setup screen
+
+// Timing decoder
+#define DECODER_DEFAULT_WPM 18
+
+// File streaming (launch argument)
+#define STREAM_PATH_MAX 128
+#define STREAM_CHUNK_SIZE 64       // Fixed read buffer, files are never loaded whole
+#define STREAM_WORD_MAX 24         // Longer words, or ones that overflow a schedule, are keyed in pieces
+#define STREAM_TEXT_SHOWN 16       // Marquee of keyed or decoded text
+#define STREAM_DEFAULT_WPM 18
+
+// Lesson packs
+#define LESSON_BUFFER_SIZE 32      // Fixed buffer drill elements stream through
+
+// Audio input decoding
+#define LISTEN_PIN gpio_ext_pa7    // GPIO 2, audio AC-coupled and biased to mid-rail
+#define LISTEN_ADC_CHANNEL FuriHalAdcChannel12
+#define LISTEN_ADC ADC1            // The one behind FuriHalAdcHandle
+#define LISTEN_SAMPLE_US (1000000 / TONE_SAMPLE_RATE)
+#define LISTEN_BLOCK_US (TONE_BLOCK_SIZE * LISTEN_SAMPLE_US)
+#define LISTEN_TIMER TIM2          // Sample clock, shared with IR and Sub-GHz, so checked free first
+#define LISTEN_FLAG_BLOCK (1 << 0)
+#define LISTEN_FLAG_STOP (1 << 1)
+#define LISTEN_LEVEL_BAR_PX 60
+#define LISTEN_GLOSS_MS 4000       // Meaning of a known word stays up this long
+#define GLITCH_STEP_PERCENT 5      // Filter strength steps in Listen
+#define GLITCH_MAX_PERCENT 60
+
+// Files on the SD card
+#define MORSE_DATA_DIR EXT_PATH("apps_data/morse_master")
+#define LADDER_HISTORY_PATH MORSE_DATA_DIR "/ladder.bin"
+#define LESSON_PACK_PATH MORSE_DATA_DIR "/lessons.mlp"
+#define STATS_PATH MORSE_DATA_DIR "/stats.bin"
+#define CONFUSION_PATH MORSE_DATA_DIR "/confusion.bin"
+#define PRACTICE_KEYLOG_PATH MORSE_DATA_DIR "/practice.mkt"
+#define QSO_LOG_PATH MORSE_DATA_DIR "/log.adi"
+#define BENCH_REPORT_PATH MORSE_DATA_DIR "/bench.txt"
+#define RESUME_PATH MORSE_DATA_DIR "/resume.bin"
+
+// Daily statistics
+#define STATS_MAGIC "MMDS"
+#define STATS_VERSION 1
+#define STATS_SECONDS_PER_DAY 86400
+#define STATS_GAP_RECORDS 8        // Zero records written per call when filling skipped days
+#define PROGRESS_SHORT_DAYS 30
+#define PROGRESS_LONG_DAYS 90
+#define PROGRESS_READ_RECORDS 10   // Records per read while loading the graph
+#define PROGRESS_GRAPH_X 8
+#define PROGRESS_GRAPH_WIDTH 90    // Divisible by both day counts
+#define PROGRESS_GRAPH_BOTTOM 54
+#define PROGRESS_GRAPH_HEIGHT 32
+
+// Echo drill and confusion matrix
+#define CONFUSION_MAGIC "MMCF"
+#define CONFUSION_VERSION 1
+#define CONFUSION_SHOWN 8          // Worst pairs on the Confusions screen
+#define ECHO_DRILL_PAIRS 8         // Worst pairs the confusion drill picks from
+#define ECHO_PAUSE_MS 1500         // Pause after the last element that submits the answer
+#define ECHO_VERDICT_MS 1200       // Verdict shown before the next character plays
+#define ECHO_SIMILAR_ROUNDS 8      // Items around one anchor before moving to a neighbour
+
+// Session resume
+#define RESUME_MAGIC "MMRS"
+#define RESUME_VERSION 2
+#define RESUME_INTERVAL_MS 2000    // Shortest time between two snapshots
+#define RESUME_IDLE_MS 800         // Quiet time after the last key before a snapshot
+
+// Self-review of Practice keying
+#define KEYLOG_SIZE SCHEDULE_MAX_ELEMENTS  // Edges kept in RAM, all of them replay
+#define KEYLOG_MAX_GAP_MS 3000     // Longer pauses are idle time, not spacing
+#define KEYLOG_MAX_MARK_MS 30000   // A key held longer is logged as this long
+#define KEYLOG_SPILL_VALUES 32     // Durations per "Timing:" line on SD
+#define SAVE_QUEUE_SIZE 8          // Writes waiting for the save worker
+#define REVIEW_PAUSE_MS 1000       // Between your replay and the ideal one
+#define REVIEW_TEXT_MAX 16
+
+// Contact log
+#define LISTEN_TRANSCRIPT_MAX 64   // Decoded text kept to prefill a contact
+#define LOG_EDIT_CHARSET " ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789/"
+
+// Send mode type-ahead keyer
+#define SEND_BUFFER_SIZE 64        // Characters typed ahead of the keying
+#define SEND_SENT_SHOWN 20         // Keyed text kept on screen
+#define SEND_UNSENT_SHOWN 16       // Newest unsent characters shown
+#define SEND_DEFAULT_WPM 20
+#define SEND_POLL_MS 10            // Idle wait of the sound worker for new text
+#define SEND_KEY_WIDTH 9
+#define SEND_KEY_HEIGHT 12
+
+// QSO partner bot
+#define QSO_OVER_MAX 48            // Decoded text of one operator over
+#define QSO_HEARD_SHOWN 20         // Operator text kept on screen
+#define QSO_NAME_MAX 8
+#define QSO_KEY_WPM 6              // Starting estimate for button keying
+#define QSO_DEFAULT_WPM 18
+#define QSO_QRS_STEP_WPM 4
+#define QSO_OVER_GAP_DOTS 10       // Silence, in the decoder's dots, that ends an over
+#define QSO_DEFAULT_DELAY_MS 600   // Pause after the over before the bot replies
+#define QSO_DELAY_MAX_MS 3000
+#define QSO_DELAY_STEP_MS 100
+
+// Keyed commands
+#define COMMAND_PREFIX '='         // BT opens a command
+#define COMMAND_NODES_MAX 48       // Trie nodes, the root included
+#define COMMAND_HEARD_MAX 6        // Prefix and command shown while keying
+#define COMMAND_TIMEOUT_MS 5000    // A command not finished by then is dropped
+#define COMMAND_KEY_WPM 6          // Starting estimate for the menu straight key
+#define COMMAND_GAP_DOTS 3         // Silence that ends a character in the menu
+
+// Screen-off practice
+#define CUE_TONE_MS 60             // Each of the two notes of a cue
+#define CUE_LOW_HZ 660
+#define CUE_HIGH_HZ 990
+#define POWER_SAMPLE_MS 1000       // Battery current sampling, screen on and off
+#define POWER_SHOWN_MS 4000        // Saving shown after the screen comes back
+
+// Benchmark suite
+#define MORSE_APP_VERSION "1.0"    // Keep in step with fap_version in application.fam
+#define BENCH_REPORT_FORMAT 1
+#define BENCH_SAMPLES 300          // Most samples of any one measurement
+#define BENCH_RESULTS 12
+#define BENCH_LOOKUP_ROUNDS 200    // Batches of every table character, encoded and decoded
+#define BENCH_SCHEDULE_ROUNDS 200
+#define BENCH_SCHEDULE_TEXT "CQ CQ DE W1AW W1AW K"
+#define BENCH_QUEUE_ROUNDS 50
+#define BENCH_QUEUE_IDLE_MS 20     // Lets the sound worker get back to waiting
+#define BENCH_JITTER_RUNS 2        // Of SCHEDULE_MAX_ELEMENTS dot elements each
+#define BENCH_JITTER_WPM 30
+#define BENCH_DRAW_ROUNDS 30
+#define BENCH_DRAW_TIMEOUT_MS 100
+#define BENCH_ROWS_SHOWN 5
 
 // Application states
 typedef enum {
@@ -30,6 +203,19 @@ typedef enum {
     MorseStateMenu,        // Main menu with icons
     MorseStateLearn,
     MorseStatePractice,
+    MorseStateFox,
+    MorseStateLadder,
+    MorseStateStream,      // Keying or decoding a file given as launch argument
+    MorseStateLessons,
+    MorseStateListen,      // Decoding audio from the ADC pin
+    MorseStateProgress,    // Daily statistics graph
+    MorseStateEcho,        // Key back the character the app plays
+    MorseStateConfusions,  // Worst expected-versus-received pairs
+    MorseStateReview,      // Replay of the last Practice keying
+    MorseStateLog,         // ADIF contact log entry
+    MorseStateSend,        // Type-ahead keyer with an on-screen keyboard
+    MorseStateQso,         // Bot station answering the operator's keying
+    MorseStateBenchmark,   // Hidden: fixed timing suite, saved to SD
     MorseStateHelp,
     MorseStateExit
 } MorseAppState;
@@ -39,21 +225,657 @@ typedef enum {
     SoundCommandNone,
     SoundCommandDot,
     SoundCommandDash,
-    SoundCommandCharacter
+    SoundCommandCharacter,
+    SoundCommandSchedule,
+    SoundCommandStream,
+    SoundCommandLesson,
+    SoundCommandReview,
+    SoundCommandSend,                   // Also keys QSO bot replies, see SendKeyer.drain
+    SoundCommandCueRight,               // Rising two-note cue
+    SoundCommandCueWrong,               // Falling two-note cue
+    SoundCommandBench                   // Only stamps when the worker picked it up
 } SoundCommand;
 
-// Morse code structure
+// Fox hunt transmitter
+typedef enum {
+    FoxFieldNumber,
+    FoxFieldFoxes,
+    FoxFieldSpeed,
+    FoxFieldGpio,
+    FoxFieldCount
+} FoxField;
+
+typedef struct {
+    uint8_t number;         // This fox, 1..foxes
+    uint8_t foxes;          // Foxes sharing the cycle, one minute each
+    uint8_t wpm;
+    bool gpio;              // Also key FOX_KEY_PIN
+    FoxField field;         // Selected config row
+    bool running;
+    volatile bool on_air;   // Keying inside the slot right now
+    volatile bool stop;     // Abort keying between elements
+    FuriThread* thread;
+    MorseSchedule schedule;
+} FoxHunt;
+
+// Max copy speed ladder test
+typedef enum {
+    LadderPhaseSetup,
+    LadderPhasePlaying,
+    LadderPhaseGrading,
+    LadderPhaseDone
+} LadderPhase;
+
+typedef enum {
+    LadderFieldBase,
+    LadderFieldStep,
+    LadderFieldMisses,
+    LadderFieldCount
+} LadderField;
+
+// One finished test as stored in LADDER_HISTORY_PATH
+typedef struct {
+    uint32_t timestamp;
+    uint32_t seed;          // Session seed, regenerates every group of the test
+    uint8_t base_wpm;
+    uint8_t max_wpm;        // Highest speed copied, 0 if none
+    uint8_t misses;         // Misses allowed per step
+    uint8_t step_wpm;
+} LadderRecord;
+
+typedef struct {
+    LadderPhase phase;
+    LadderField field;
+    uint8_t base_wpm;
+    uint8_t step_wpm;
+    uint8_t max_misses;
+    uint8_t wpm;            // Current step
+    uint8_t best_wpm;       // Highest step passed
+    uint8_t copied;         // Groups copied at the current step
+    uint8_t misses;         // Groups missed at the current step
+    uint8_t group;          // Group being played within the step
+    char groups[LADDER_GROUPS_PER_STEP][LADDER_GROUP_SIZE + 1];
+    MorseSchedule schedules[LADDER_GROUPS_PER_STEP];
+    LadderRecord history[LADDER_HISTORY_SHOWN];
+    uint8_t history_count;
+} LadderTest;
+
+// Streaming a file: text is keyed, timing recordings are replayed and decoded
+typedef enum {
+    StreamKindText,
+    StreamKindTiming
+} StreamKind;
+
+typedef struct {
+    char path[STREAM_PATH_MAX];
+    StreamKind kind;
+    uint8_t wpm;
+    volatile bool done;
+    bool failed;                        // File could not be opened
+    uint32_t characters;                // Characters keyed or decoded
+    uint32_t launch_us;                 // App entry, for the time to first element
+    int32_t first_element_us;           // -1 until the first element keys
+    char text[STREAM_TEXT_SHOWN + 1];
+    MorseDecoder decoder;
+    MorseGlitchFilter filter;
+    MorseSchedule schedule;
+} MorseStream;
+
+// Lesson pack browser; only the selected lesson's index entry and header are in RAM
+typedef struct {
+    uint16_t lesson_count;              // 0 if no pack was found
+    uint16_t selected;
+    LessonIndexEntry entry;
+    LessonHeader header;
+    char text[LESSON_TEXT_MAX + 1];     // Drill being played
+    uint16_t drill;                     // Drill being played, 1-based while playing
+} LessonBrowser;
+
+// Audio input decoder; a timer interrupt samples, the worker detects the tone and decodes
+typedef struct {
+    bool running;
+    bool timer_busy;                    // Sample timer was taken, Listen could not start
+    volatile bool stop;
+    FuriThread* thread;
+    FuriHalAdcHandle* adc;
+    uint16_t blocks[2][TONE_BLOCK_SIZE];  // Sample interrupt fills one while the worker reads the other
+    uint8_t filling;                    // Block the interrupt writes
+    uint16_t filled;                    // Samples in it so far
+    volatile uint8_t ready;             // Block last completed; the worker has one block's time to read it
+    MorseToneDetector tone;
+    MorseDecoder decoder;
+    MorseGlitchFilter filter;
+    volatile bool key;
+    volatile uint8_t dsp_load;          // Percent of each block the worker is awake
+    char text[STREAM_TEXT_SHOWN + 1];
+    char transcript[LISTEN_TRANSCRIPT_MAX + 1];  // Longer history for the contact log
+    bool glossary;                      // Look up each word as it ends
+    const MorseGloss* volatile gloss;   // Last word found, set by the worker
+    volatile uint32_t gloss_tick;
+} MorseListener;
+
+// Header of STATS_PATH. Record N holds day first_day + N, days without training
+// are zero records, so any date range is one seek away.
+typedef struct {
+    char magic[4];
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t first_day;                 // Days since 1970-01-01 in RTC time
+} StatsHeader;
+
+// One day's rollup as stored in STATS_PATH
+typedef struct {
+    uint32_t wpm_total;                 // Sum of speed samples, for the average
+    uint16_t wpm_samples;
+    uint16_t characters;                // Characters played, keyed or copied
+    uint16_t graded;                    // Characters checked right or wrong
+    uint16_t correct;
+    uint16_t seconds;                   // Time spent in training modes
+    uint8_t max_wpm;
+    uint8_t reserved;
+} DailyStats;
+
+_Static_assert(sizeof(StatsHeader) == 12, "StatsHeader layout");
+_Static_assert(sizeof(DailyStats) == 16, "DailyStats layout");
+
+// Today's rollup, kept in RAM and written back when a mode is left
+typedef struct {
+    uint32_t day;
+    DailyStats today;
+    uint32_t active_ms;                 // Training time not yet added to today.seconds
+    uint32_t last_tick;
+    bool dirty;
+    MorseAppState last_state;
+    uint16_t lesson_drill;              // Last lesson drill counted
+} StatsTracker;
+
+typedef enum {
+    ProgressMetricCharacters,
+    ProgressMetricAccuracy,
+    ProgressMetricAverageWpm,
+    ProgressMetricMaxWpm,
+    ProgressMetricMinutes,
+    ProgressMetricCount
+} ProgressMetric;
+
+// Graph of the last days, oldest first; only those records are read
+typedef struct {
+    uint8_t days;
+    ProgressMetric metric;
+    bool empty;                         // No training in the range
+    uint16_t values[ProgressMetricCount][PROGRESS_LONG_DAYS];
+} ProgressGraph;
+
+// Header of CONFUSION_PATH, followed by the counters row by row
+typedef struct {
+    char magic[4];
+    uint16_t version;
+    uint8_t rows;
+    uint8_t columns;
+} ConfusionHeader;
+
+_Static_assert(sizeof(ConfusionHeader) == 8, "ConfusionHeader layout");
+
+// One slot of RESUME_PATH. The two slots are written in turn and the valid one
+// with the higher sequence wins, so a write cut short by a reset leaves the
+// previous snapshot readable.
+typedef struct {
+    char magic[4];
+    uint16_t version;
+    uint16_t size;                      // sizeof(ResumeSnapshot)
+    uint32_t sequence;
+    uint32_t seed;                      // Session seed and generator position
+    MorseRng rng;
+    uint32_t dot_us;                    // Listen decoder speed estimate
+    uint8_t state;                      // MorseAppState
+    uint8_t learn_set;
+    char current_char;
+    char last_decoded_char;
+    uint8_t auto_add_space;
+    uint8_t echo_source;
+    uint8_t echo_anchor;
+    uint8_t echo_round;
+    uint16_t echo_right;
+    uint16_t echo_total;
+    char decoded_text[MAX_MORSE_LENGTH];
+    char user_input[MAX_MORSE_LENGTH];
+    char current_morse[MAX_MORSE_LENGTH];  // Practice character being keyed
+    char top_words[TOP_WORDS_MAX_LENGTH + 1];
+    uint8_t input_position;
+    uint8_t morse_position;
+    uint8_t reserved[3];
+    MorseCharset learn_custom;
+    uint32_t crc;                       // Of everything before it
+    uint32_t padding;                   // Size stays a multiple of 8
+} ResumeSnapshot;
+
+_Static_assert(sizeof(ResumeSnapshot) == 104, "ResumeSnapshot layout");
+
+typedef struct {
+    ResumeSnapshot written;             // Newest snapshot on SD, save worker only once it runs
+    ResumeSnapshot captured;            // Last state queued, unchanged state is not queued again
+    uint32_t write_tick;
+} SessionResume;
+
+// Launch argument mode names
+typedef struct {
+    const char* name;
+    MorseAppState state;
+} LaunchMode;
+
+// Menu entries, shown three to a page
+typedef struct {
+    const char* title;
+    const Icon* icon;
+    MorseAppState state;
+} MenuItem;
+
+// Rasterised code image in XBM layout, row stride is (width + 7) / 8
+typedef struct {
+    uint8_t width;
+    uint8_t height;
+    uint8_t bits[GLYPH_MAX_HEIGHT * GLYPH_MAX_STRIDE];
+} MorseGlyph;
+
+// Where the Echo drill takes its characters from
+typedef enum {
+    EchoSourceAll,
+    EchoSourceConfusions,               // Worst confused pairs
+    EchoSourceSimilar,                  // Alternates a character with its closest codes
+    EchoSourceCount
+} EchoSource;
+
+// Echo drill: the app plays a character, the user keys it back
+typedef struct {
+    EchoSource source;
+    uint8_t anchor;                     // Similar: table index the items alternate around
+    uint8_t round;                      // Similar: items played around the anchor
+    char target;
+    char code[MAX_MORSE_LENGTH];
+    uint8_t code_length;
+    uint32_t last_key_tick;             // Last element keyed
+    char received;                      // Graded answer, 0 while keying
+    uint32_t verdict_tick;
+    uint16_t right;
+    uint16_t total;
+    MorseGlyph glyph;                   // Of code
+} EchoDrill;
+
+// Practice key edges as signed us, marks positive. Written by the key handler
+// on the main loop and drained to SD behind the written count by the save
+// worker. The counts only grow, so a new session never pulls one back.
+typedef struct {
+    int32_t elements[KEYLOG_SIZE];
+    volatile uint32_t written;          // Elements ever written, the ring index is modulo
+    uint32_t start;                     // written when this session began
+    uint32_t spill_queued;              // written when a spill was last queued
+    uint32_t spilled;                   // Elements already on SD, save worker only
+    uint32_t edge_us;                   // Last press or release, morse_clock_us
+    bool key_down;
+    bool spill;                         // Copy each session to PRACTICE_KEYLOG_PATH
+    bool spill_open;                    // File started for this session, save worker only
+} KeyLog;
+
+// SD writes queued for the save worker, so a key press never waits behind one
+typedef enum {
+    SaveJobKeylog,                      // Complete "Timing:" lines up to keylog_count
+    SaveJobKeylogFlush,                 // Up to keylog_count, a partial line included
+    SaveJobKeylogStart,                 // A new Practice session from keylog_count
+    SaveJobStats,
+    SaveJobResume,
+    SaveJobStop,
+} SaveJobType;
+
+typedef struct {
+    SaveJobType type;
+    union {
+        uint32_t keylog_count;          // KeyLog written when queued
+        struct {
+            uint32_t day;
+            DailyStats today;
+        } stats;
+        ResumeSnapshot resume;
+    };
+} SaveJob;
+
+typedef enum {
+    ReviewPlayBoth,
+    ReviewPlayOwn,
+    ReviewPlayIdeal
+} ReviewPlay;
+
+// The keyed session next to the same elements at exact timing
+typedef struct {
+    int32_t own_us[SCHEDULE_MAX_ELEMENTS];  // As keyed
+    MorseSchedule own;                  // As keyed, rounded to ms for replay
+    MorseSchedule ideal;                // Quantised to dot units, then ms at the keyed speed
+    uint8_t wpm;
+    uint16_t dash_x10;                  // Average dash over average dot, ideal 30
+    uint16_t gap_x10;                   // Average element gap over average dot, ideal 10
+    char text[REVIEW_TEXT_MAX + 1];
+    ReviewPlay request;
+    volatile ReviewPlay playing;
+    volatile bool active;               // A replay is running
+} SelfReview;
+
+typedef enum {
+    LogFieldCall,
+    LogFieldBand,
+    LogFieldSent,
+    LogFieldReceived,
+    LogFieldExchange,
+    LogFieldCount
+} LogField;
+
+// Contact being entered; finished records collect in the writer's buffer
+typedef struct {
+    AdifQso qso;
+    AdifWriter writer;
+    LogField field;
+    bool editing;                       // Changing characters of a text field
+    uint8_t cursor;
+    uint8_t band;                       // Index into ADIF_BANDS, kept between contacts
+    uint16_t logged;                    // Contacts this session
+} QsoLog;
+
+// Type-ahead ring: the keyboard appends and deletes at head, the sound worker
+// takes from tail. Indices only grow, the slot is the index modulo the size.
+// The mutex covers single index updates, never any keying.
+typedef struct {
+    char ring[SEND_BUFFER_SIZE];
+    uint32_t head;
+    uint32_t tail;
+    FuriMutex* mutex;
+    volatile char keying;               // Character on the air, 0 between characters
+    bool drain;                         // Worker returns once the ring is empty
+    char sent[SEND_SENT_SHOWN + 1];
+    uint8_t wpm;
+    uint8_t row;                        // 0: speed, then the keyboard rows
+    uint8_t column;
+} SendKeyer;
+
+typedef enum {
+    QsoBotListening,                    // Waiting for a CQ or a call
+    QsoBotCalled,                       // Answered a CQ with our call
+    QsoBotReported,                     // Sent report and name
+    QsoBotClosing,                      // Sent final, waiting for 73
+    QsoBotCount,
+    QsoBotAny = QsoBotCount,            // Rule matches in every state
+    QsoBotStay = QsoBotCount,           // Rule keeps the state
+} QsoBotState;
+
+// What an over contained; one over can raise several
+typedef enum {
+    QsoEventRepeat,                     // ?, AGN or RPT on its own
+    QsoEventSlower,                     // QRS
+    QsoEventCq,
+    QsoEventCall,                       // The bot's own call
+    QsoEventReport,                     // An RST
+    QsoEventClose,                      // 73, SK or GB
+    QsoEventOther,                      // None of the above
+} QsoEvent;
+
+#define QSO_EVENT(event) (1u << (event))
+
+// First rule whose state and any of whose events match is taken. A NULL reply
+// repeats the last one. In replies $C is the bot's call, $N its name, $R the
+// report it gives, $O and $P the operator's call and name as copied.
+typedef struct {
+    QsoBotState state;
+    uint8_t events;
+    QsoBotState next;
+    int8_t wpm_step;
+    const char* reply;
+} QsoRule;
+
+// Operator decoder, reply state and the station the bot plays
+typedef struct {
+    MorseDecoder decoder;
+    MorseGlitchFilter filter;
+    QsoBotState state;
+    char over[QSO_OVER_MAX + 1];
+    uint8_t over_length;
+    char heard[QSO_HEARD_SHOWN + 1];
+    uint32_t edge_us;                   // Last press or release, morse_clock_us
+    bool key_down;
+    bool keyed;                         // Elements since the last over ended
+    char call[ADIF_CALL_MAX + 1];
+    const char* name;
+    const char* report;
+    char op_call[ADIF_CALL_MAX + 1];
+    char op_name[QSO_NAME_MAX + 1];
+    char reply[SEND_BUFFER_SIZE];       // Last reply, for ? and QRS
+    uint16_t delay_ms;
+    uint8_t wpm;
+} QsoBot;
+
+typedef enum {
+    CommandMode,                        // Leave the current mode for another
+    CommandSpeed,                       // Send keyer speed, the bot's too in QSO
+    CommandVolume,                      // 0 mutes, 9 is full volume
+    CommandOff,                         // Back to the buttons alone
+} CommandAction;
+
+// '#' in the text stands for one digit of the argument. No command may be a
+// prefix of another: a command runs as soon as its last character is decoded.
+typedef struct {
+    const char* text;
+    CommandAction action;
+    MorseAppState state;
+} MorseCommand;
+
+typedef struct {
+    char character;                     // '#' matches any digit
+    uint8_t child;                      // First child, 0 for none (the root is no child)
+    uint8_t sibling;                    // Next alternative after the same prefix
+    int8_t command;                     // Index into MORSE_COMMANDS ending here, -1 if none
+} CommandNode;
+
+// Morse control: characters decoded in Practice, the QSO Bot and, on a
+// straight key, the menu walk a trie of commands one node each
+typedef struct {
+    bool enabled;
+    CommandNode nodes[COMMAND_NODES_MAX];
+    uint8_t node_count;
+    int16_t node;                       // Trie position, -1 until the prefix is heard
+    uint16_t value;                     // Argument digits so far
+    uint32_t char_tick;
+    int8_t pending;                     // Command for the main loop to run, -1 for none
+    uint16_t pending_value;
+    char heard[COMMAND_HEARD_MAX + 1];
+    MorseDecoder decoder;               // Menu straight key
+    MorseGlitchFilter filter;
+    uint32_t edge_us;
+    bool key_down;
+    bool keyed;                         // Elements since the last character ended
+} MorseCommander;
+
+// '_' is the space bar and '<' deletes the newest unsent character
+static const char* const SEND_KEYBOARD[] = {
+    "ABCDEFGHIJKLM",
+    "NOPQRSTUVWXYZ",
+    "0123456789_<",
+};
+
+#define SEND_KEYBOARD_ROWS (int)COUNT_OF(SEND_KEYBOARD)
+
+static const MorseCommand MORSE_COMMANDS[] = {
+    {"LE", CommandMode, MorseStateLearn},
+    {"PR", CommandMode, MorseStatePractice},
+    {"FX", CommandMode, MorseStateFox},
+    {"LD", CommandMode, MorseStateLadder},
+    {"LS", CommandMode, MorseStateLessons},
+    {"LI", CommandMode, MorseStateListen},
+    {"PG", CommandMode, MorseStateProgress},
+    {"EC", CommandMode, MorseStateEcho},
+    {"CF", CommandMode, MorseStateConfusions},
+    {"RV", CommandMode, MorseStateReview},
+    {"LG", CommandMode, MorseStateLog},
+    {"SD", CommandMode, MorseStateSend},
+    {"QB", CommandMode, MorseStateQso},
+    {"HP", CommandMode, MorseStateHelp},
+    {"MN", CommandMode, MorseStateMenu},
+    {"S##", CommandSpeed, MorseStateMenu},
+    {"V#", CommandVolume, MorseStateMenu},
+    {"SK", CommandOff, MorseStateMenu},
+    {">", CommandOff, MorseStateMenu},
+};
+
+typedef struct {
+    const char* name;
+    uint32_t min;
+    uint32_t avg;
+    uint32_t p99;
+    uint16_t count;
+} BenchResult;
+
+// Benchmark runner and the probes it reads from the GUI and sound threads
+typedef struct {
+    FuriThread* thread;
+    volatile bool running;
+    volatile bool stop;
+    BenchResult results[BENCH_RESULTS];
+    volatile uint8_t result_count;
+    uint8_t scroll;
+    bool saved;
+    uint32_t samples[BENCH_SAMPLES];
+
+    // Draw probe: the draw callback renders draw_screen and reports its cycles
+    volatile bool draw_probe;
+    volatile MorseAppState draw_screen;
+    volatile uint32_t draw_cycles;
+    volatile bool draw_done;
+
+    // Queue probe: morse_clock_us when the sound worker took SoundCommandBench
+    volatile uint32_t started_us;
+    volatile bool started;
+
+    // Jitter probe: play_schedule stamps each element start here when set, in morse_clock_us
+    uint32_t* volatile edges;
+} BenchSuite;
+
+// Screens timed by the draw probe
+static const struct {
+    const char* name;
+    MorseAppState state;
+} BENCH_SCREENS[] = {
+    {"Draw Menu", MorseStateMenu},
+    {"Draw Learn", MorseStateLearn},
+    {"Draw Practice", MorseStatePractice},
+    {"Draw Echo", MorseStateEcho},
+    {"Draw Progress", MorseStateProgress},
+    {"Draw Send", MorseStateSend},
+    {"Draw Log", MorseStateLog},
+    {"Draw Help", MorseStateHelp},
+};
+
+_Static_assert(4 + COUNT_OF(BENCH_SCREENS) <= BENCH_RESULTS, "BENCH_RESULTS too small");
+
+static const MenuItem MENU_ITEMS[] = {
+    {"Learn", &I_learn, MorseStateLearn},
+    {"Practice", &I_practice, MorseStatePractice},
+    {"Fox Hunt", &I_practice, MorseStateFox},
+    {"Speed Ladder", &I_learn, MorseStateLadder},
+    {"Lessons", &I_learn, MorseStateLessons},
+    {"Listen", &I_parrot, MorseStateListen},
+    {"Progress", &I_learn, MorseStateProgress},
+    {"Echo", &I_practice, MorseStateEcho},
+    {"Confusions", &I_learn, MorseStateConfusions},
+    {"Review", &I_parrot, MorseStateReview},
+    {"Log", &I_learn, MorseStateLog},
+    {"Send", &I_practice, MorseStateSend},
+    {"QSO Bot", &I_parrot, MorseStateQso},
+    {"Help", &I_parrot, MorseStateHelp},
+    {"Benchmark", &I_learn, MorseStateBenchmark},  // Hidden, see MENU_HIDDEN_COUNT
+};
+
+#define MENU_ITEMS_COUNT (int)(sizeof(MENU_ITEMS) / sizeof(MENU_ITEMS[0]))
+#define MENU_HIDDEN_COUNT 1        // Trailing entries shown only after holding UP in the menu
+#define MENU_PAGE_SIZE 3
+
+// Learn character sets, labelled by the UP/DOWN arrows. The last one is picked
+// by the user, a character at a time.
+typedef struct {
+    const char* label;
+    MorseCharset set;
+} LearnSet;
+
+static const LearnSet LEARN_SETS[] = {
+    {"A-Z", MORSE_CHARSET_LETTERS},
+    {"0-9", MORSE_CHARSET_DIGITS},
+    {".,?", MORSE_CHARSET_PUNCTUATION},
+    {"AR", MORSE_CHARSET_PROSIGNS},
+    {"My", 0},
+};
+
+#define LEARN_SET_COUNT (uint8_t)COUNT_OF(LEARN_SETS)
+#define LEARN_SET_CUSTOM (LEARN_SET_COUNT - 1)
+
+static const LaunchMode LAUNCH_MODES[] = {
+    {"learn", MorseStateLearn},
+    {"practice", MorseStatePractice},
+    {"fox", MorseStateFox},
+    {"ladder", MorseStateLadder},
+    {"lessons", MorseStateLessons},
+    {"listen", MorseStateListen},
+    {"progress", MorseStateProgress},
+    {"echo", MorseStateEcho},
+    {"confusions", MorseStateConfusions},
+    {"review", MorseStateReview},
+    {"log", MorseStateLog},
+    {"send", MorseStateSend},
+    {"qso", MorseStateQso},
+    {"help", MorseStateHelp},
+    {"benchmark", MorseStateBenchmark},
+};
+
+// Classic fox IDs by fox number
+static const char* const FOX_IDS[FOX_MAX_FOXES] = {"MOE", "MOI", "MOS", "MOH", "MO5"};
+
+// Green LED flashes in Practice. The notification service times them, so the
+// key handler never sleeps through one.
+static const NotificationSequence sequence_flash_green_100 = {
+    &message_red_0,
+    &message_blue_0,
+    &message_green_255,
+    &message_delay_100,
+    &message_green_0,
+    NULL,
+};
+
+static const NotificationSequence sequence_flash_green_200 = {
+    &message_red_0,
+    &message_blue_0,
+    &message_green_255,
+    &message_delay_100,
+    &message_delay_100,
+    &message_green_0,
+    NULL,
+};
+
+// Average battery draw with the screen on and off, training modes only
+typedef struct {
+    float sum_ma[2];                    // Indexed by screen_off
+    uint32_t samples[2];
+    uint32_t sample_tick;
+    int32_t saved_ma;                   // Last comparison, mA less with the screen off
+    uint32_t shown_tick;                // When the screen came back, 0 when not shown
+} PowerMeter;
+
+// A key event as queued by the GUI thread for the main loop, which handles
+// all input so it never races the main loop's own ticks
 typedef struct {
-    char character;
-    const char* code;
-} MorseCode;
+    InputEvent input;
+    uint32_t time_us;                   // morse_clock_us as the event arrived
+} MorseInputMessage;
 
 // Main application structure
 typedef struct {
     // UI elements
     Gui* gui;
     ViewPort* view_port;
-    FuriMessageQueue* event_queue;
+    FuriMessageQueue* event_queue;      // MorseInputMessage
+    uint32_t input_time_us;             // Arrival time of the event being handled
     NotificationApp* notifications;
 
     // Sound processing
@@ -63,10 +885,27 @@ typedef struct {
     SoundCommand current_sound;
     char sound_character;
     float volume;  // Volume level from 0.0 to 1.0
+    const MorseSchedule* sound_schedule;  // Schedule for SoundCommandSchedule
+    volatile bool sound_busy;             // Schedule still keying
+    volatile bool sound_abort;            // Stop the schedule between elements
+
+    // Persistence
+    FuriThread* save_thread;
+    FuriMessageQueue* save_queue;       // SaveJob
+
+    // Random content
+    MorseRng rng;
+    uint32_t session_seed;  // Seed of the current session, replays the exact same sequence
 
     // Application state
     MorseAppState app_state;
     int menu_selection;
+    bool menu_unlocked;                  // Hidden entries are listed
+    uint8_t filter_percent;              // Glitch filter for Listen, replays and the QSO bot
+    bool glossary;                       // Listen shows the meaning of known words
+    volatile bool screen_off;            // No drawing at all, audio and haptic cues only
+    bool screen_key_held;                // DOWN held for the toggle, its repeats are ignored
+    PowerMeter power;
     bool is_running;
     bool input_active;  // Flag to track if input is active (for UI animation)
 
@@ -74,57 +913,69 @@ typedef struct {
     char current_char;
     char user_input[MAX_MORSE_LENGTH];
     int input_position;
-    bool learning_letters_mode;  // True for letters, false for numbers
+    uint8_t learn_set;           // Index into LEARN_SETS
+    MorseCharset learn_custom;   // The user's own set
 
     // Practice
-    uint32_t last_input_time;
+    uint32_t last_input_time;           // morse_clock_us of the last element, 0 when none
     char decoded_text[MAX_MORSE_LENGTH];
     char top_words[TOP_WORDS_MAX_LENGTH + 1];  // Buffer for marquee display
     char current_morse[MAX_MORSE_LENGTH];
     int current_morse_position;
     bool auto_add_space;
     char last_decoded_char;  // Store the last decoded character
-} MorseApp;
 
-// International Morse Code mappings (simplified subset)
-static const MorseCode MORSE_TABLE[] = {
-    {'A', ".-"},
-    {'B', "-..."},
-    {'C', "-.-."},
-    {'D', "-.."},
-    {'E', "."},
-    {'F', "..-."},
-    {'G', "--."},
-    {'H', "...."},
-    {'I', ".."},
-    {'J', ".---"},
-    {'K', "-.-"},
-    {'L', ".-.."},
-    {'M', "--"},
-    {'N', "-."},
-    {'O', "---"},
-    {'P', ".--."},
-    {'Q', "--.-"},
-    {'R', ".-."},
-    {'S', "..."},
-    {'T', "-"},
-    {'U', "..-"},
-    {'V', "...-"},
-    {'W', ".--"},
-    {'X', "-..-"},
-    {'Y', "-.--"},
-    {'Z', "--.."},
-    {'0', "-----"},
-    {'1', ".----"},
-    {'2', "..---"},
-    {'3', "...--"},
-    {'4', "....-"},
-    {'5', "....."},
-    {'6', "-...."},
-    {'7', "--..."},
-    {'8', "---.."},
-    {'9', "----."},
-};
+    // Fox hunt
+    FoxHunt fox;
+
+    // Max copy speed ladder
+    LadderTest ladder;
+
+    // File given as launch argument
+    MorseStream stream;
+
+    // Lesson pack
+    LessonBrowser lessons;
+
+    // Audio input
+    MorseListener listen;
+
+    // Daily statistics
+    StatsTracker stats;
+    ProgressGraph progress;
+
+    // Expected-versus-received counters and the drill feeding them
+    MorseConfusion confusion;
+    MorseSimilarity similarity;
+    EchoDrill echo;
+
+    // Practice key edges and their replay
+    KeyLog keylog;
+    SelfReview review;
+
+    // Contact log
+    QsoLog log;
+
+    // Type-ahead sending
+    SendKeyer send;
+
+    // Bot station, keys its replies through the send ring
+    QsoBot qso;
+
+    // Keyed commands
+    MorseCommander commander;
+
+    // On-device benchmark
+    BenchSuite bench;
+
+    // Snapshot of the session for the next launch
+    SessionResume resume;
+
+    // Code glyphs, one per table entry, rendered once at startup
+    MorseGlyph glyph_cache[MORSE_TABLE_SIZE];
+    MorseGlyph input_glyph;                    // Glyph of current_morse
+    char input_glyph_code[MAX_MORSE_LENGTH];   // Code input_glyph was rendered from
+} MorseApp;
 
 // Function prototypes
 static void morse_app_draw_callback(Canvas* canvas, void* ctx);
@@ -132,34 +983,131 @@ static void morse_app_input_callback(InputEvent* input_event, void* ctx);
 static void play_dot(MorseApp* app);
 static void play_dash(MorseApp* app);
 static void play_character(MorseApp* app, char ch);
-static const char* get_morse_for_char(char c);
+static void render_glyph(MorseGlyph* glyph, const char* code, uint8_t max_width);
+static void draw_glyph(Canvas* canvas, int32_t x, int32_t y, const MorseGlyph* glyph);
 static int32_t sound_worker_thread(void* context);
-static char get_char_for_morse(const char* morse);
 static void try_decode_morse(MorseApp* app);
 static void update_top_words_marquee(MorseApp* app, char new_char);
+static void start_session(MorseApp* app, uint32_t seed);
+static bool play_schedule(MorseApp* app, const MorseSchedule* schedule, bool gpio, volatile bool* abort);
+static void fox_start(MorseApp* app);
+static void fox_stop(MorseApp* app);
+static void play_schedule_async(MorseApp* app, const MorseSchedule* schedule);
+static void ladder_load_history(MorseApp* app);
+static void stream_run(MorseApp* app);
+static void lesson_play(MorseApp* app);
+static void enter_state(MorseApp* app, MorseAppState state);
+static void listen_stop(MorseApp* app);
+static void marquee_push(char* buffer, size_t max_length, char new_char);
+static void stats_add_characters(MorseApp* app, uint16_t characters, uint16_t graded, uint16_t correct);
+static void stats_add_wpm(MorseApp* app, uint8_t wpm);
+static void review_play(MorseApp* app);
+static void send_run(MorseApp* app);
+static void command_feed(MorseApp* app, char character);
+static void bench_stop(MorseApp* app);
 
-// Get morse code for a character
-static const char* get_morse_for_char(char c) {
-    c = toupper(c);
+static int menu_item_count(const MorseApp* app) {
+    return app->menu_unlocked ? MENU_ITEMS_COUNT : MENU_ITEMS_COUNT - MENU_HIDDEN_COUNT;
+}
 
-    for(size_t i = 0; i < sizeof(MORSE_TABLE) / sizeof(MORSE_TABLE[0]); i++) {
-        if(MORSE_TABLE[i].character == c) {
-            return MORSE_TABLE[i].code;
-        }
+// Every redraw goes through here; with the screen off nothing is drawn
+static void morse_view_update(MorseApp* app) {
+    if(!app->screen_off) view_port_update(app->view_port);
+}
+
+// Start a new session from a seed; the seed alone regenerates its content
+static void start_session(MorseApp* app, uint32_t seed) {
+    app->session_seed = seed;
+    morse_rng_seed(&app->rng, seed);
+    FURI_LOG_I("MorseMaster", "Session seed %08lX", (unsigned long)seed);
+}
+
+// Compare generator speed against libc rand() on the device (debug mode only)
+static void benchmark_rng(void) {
+    MorseRng rng;
+    morse_rng_seed(&rng, 1);
+    volatile uint32_t sink = 0;
+
+    uint32_t start = furi_get_tick();
+    for(uint32_t i = 0; i < RNG_BENCHMARK_ROUNDS; i++) {
+        sink ^= (uint32_t)rand();
+    }
+    uint32_t rand_ms = furi_get_tick() - start;
+
+    start = furi_get_tick();
+    for(uint32_t i = 0; i < RNG_BENCHMARK_ROUNDS; i++) {
+        sink ^= morse_rng_next(&rng);
+    }
+    uint32_t rng_ms = furi_get_tick() - start;
+
+    UNUSED(sink);
+    FURI_LOG_I(
+        "MorseMaster",
+        "PRNG benchmark, %d draws: rand() %lu ms, xoshiro128** %lu ms",
+        RNG_BENCHMARK_ROUNDS,
+        (unsigned long)rand_ms,
+        (unsigned long)rng_ms);
+}
+
+// Set a horizontal run of pixels in an XBM bitmap
+static void glyph_fill_row(MorseGlyph* glyph, uint8_t stride, int x, int y, int width) {
+    for(int px = x; px < x + width; px++) {
+        glyph->bits[y * stride + px / 8] |= (uint8_t)(1 << (px % 8));
     }
+}
 
-    return NULL;
+// Dot, dash and gap widths, largest first. The first three keep the 1:3:1
+// timing ratio; the last two give up gap and dash width so the longest codes
+// still fit a 31 px panel with dashes plainly longer than dots.
+static const uint8_t GLYPH_LAYOUTS[][3] = {{4, 12, 4}, {3, 9, 3}, {2, 6, 2}, {2, 6, 1}, {2, 5, 1}};
+
+static int glyph_layout_width(const char* code, const uint8_t* layout) {
+    int width = 0;
+    for(size_t i = 0; code[i] != '\0'; i++) {
+        width += (i > 0 ? layout[2] : 0) + (code[i] == '-' ? layout[1] : layout[0]);
+    }
+    return width;
 }
 
-// Get character for a morse code
-static char get_char_for_morse(const char* morse) {
-    for(size_t i = 0; i < sizeof(MORSE_TABLE) / sizeof(MORSE_TABLE[0]); i++) {
-        if(strcmp(MORSE_TABLE[i].code, morse) == 0) {
-            return MORSE_TABLE[i].character;
+// Rasterise a code string into a glyph on a single row, in the largest
+// layout that fits max_width. A code is never split across rows.
+static void render_glyph(MorseGlyph* glyph, const char* code, uint8_t max_width) {
+    memset(glyph, 0, sizeof(MorseGlyph));
+    if(!code || code[0] == '\0') return;
+    if(max_width > GLYPH_MAX_WIDTH) max_width = GLYPH_MAX_WIDTH;
+
+    const size_t layout_count = sizeof(GLYPH_LAYOUTS) / sizeof(GLYPH_LAYOUTS[0]);
+    const uint8_t* layout = GLYPH_LAYOUTS[layout_count - 1];
+    for(size_t i = 0; i < layout_count; i++) {
+        if(glyph_layout_width(code, GLYPH_LAYOUTS[i]) <= max_width) {
+            layout = GLYPH_LAYOUTS[i];
+            break;
+        }
+    }
+    int width = glyph_layout_width(code, layout);
+    glyph->width = (uint8_t)(width < max_width ? width : max_width);
+    glyph->height = (uint8_t)(layout[0] + 1);
+    uint8_t stride = (uint8_t)((glyph->width + 7) / 8);
+
+    // Corners are left clear on wider elements so dots read as round and bars as rounded
+    int x = 0;
+    for(size_t i = 0; code[i] != '\0'; i++) {
+        int element = (code[i] == '-') ? layout[1] : layout[0];
+        if(x + element > glyph->width) break;  // Only if even the smallest layout is too wide
+        int inset = (element >= 3) ? 1 : 0;
+        glyph_fill_row(glyph, stride, x + inset, 0, element - 2 * inset);
+        for(int row = 1; row < glyph->height - 1; row++) {
+            glyph_fill_row(glyph, stride, x, row, element);
         }
+        glyph_fill_row(glyph, stride, x + inset, glyph->height - 1, element - 2 * inset);
+        x += element + layout[2];
     }
+}
 
-    return '?';  // Unknown morse code
+// Blit a prebuilt glyph with the current canvas color
+static void draw_glyph(Canvas* canvas, int32_t x, int32_t y, const MorseGlyph* glyph) {
+    if(glyph->width == 0) return;
+    canvas_draw_xbm(canvas, x, y, glyph->width, glyph->height, glyph->bits);
 }
 
 // Sound worker thread function - handles all audio output
@@ -292,6 +1240,63 @@ static int32_t sound_worker_thread(void* context) {
                     }
                     break;
 
+                case SoundCommandSchedule:
+                    // Play a pre-encoded schedule, no encoding happens while keying
+                    if(app->sound_schedule) {
+                        play_schedule(app, app->sound_schedule, false, &app->sound_abort);
+                    }
+                    app->sound_busy = false;
+                    morse_view_update(app);
+                    break;
+
+                case SoundCommandStream:
+                    // Key or decode the launch file chunk by chunk
+                    stream_run(app);
+                    app->sound_busy = false;
+                    morse_view_update(app);
+                    break;
+
+                case SoundCommandLesson:
+                    // Stream the selected lesson's pre-encoded drills
+                    lesson_play(app);
+                    app->sound_busy = false;
+                    morse_view_update(app);
+                    break;
+
+                case SoundCommandReview:
+                    // Replay the practice keying, the ideal timing, or both
+                    review_play(app);
+                    app->sound_busy = false;
+                    morse_view_update(app);
+                    break;
+
+                case SoundCommandSend:
+                    // Key typed text until Send mode is left, or one bot reply
+                    send_run(app);
+                    app->sound_busy = false;
+                    break;
+
+                case SoundCommandCueRight:
+                case SoundCommandCueWrong:
+                    // Two short notes, up for right and down for wrong
+                    if(furi_hal_speaker_acquire(1000)) {
+                        bool right = command == SoundCommandCueRight;
+                        float volume = (app->volume > 0.0f) ? app->volume : INITIAL_VOLUME;
+                        furi_hal_speaker_start(right ? CUE_LOW_HZ : CUE_HIGH_HZ, volume);
+                        furi_delay_ms(CUE_TONE_MS);
+                        furi_hal_speaker_stop();
+                        furi_hal_speaker_start(right ? CUE_HIGH_HZ : CUE_LOW_HZ, volume);
+                        furi_delay_ms(CUE_TONE_MS);
+                        furi_hal_speaker_stop();
+                        furi_hal_speaker_release();
+                    }
+                    break;
+
+                case SoundCommandBench:
+                    app->bench.started_us = morse_clock_us();
+                    app->bench.started = true;
+                    break;
+
                 default:
                     break;
             }
@@ -317,6 +1322,13 @@ static void play_dash(MorseApp* app) {
     furi_message_queue_put(app->sound_queue, &cmd, 0);
 }
 
+// Verdict for someone not looking at the screen; a wrong one also buzzes
+static void play_cue(MorseApp* app, bool right) {
+    SoundCommand cmd = right ? SoundCommandCueRight : SoundCommandCueWrong;
+    furi_message_queue_put(app->sound_queue, &cmd, 0);
+    if(!right) notification_message(app->notifications, &sequence_single_vibro);
+}
+
 // Play a complete morse character
 static void play_character(MorseApp* app, char ch) {
     app->sound_character = ch;
@@ -326,11 +1338,11 @@ static void play_character(MorseApp* app, char ch) {
 
 // Function to try to decode current morse code if there's been a pause
 static void try_decode_morse(MorseApp* app) {
-    uint32_t current_time = furi_hal_rtc_get_timestamp();
+    uint32_t current_time = morse_clock_us();
 
     // Check if enough time has passed since last input (pause detected)
     if(app->last_input_time > 0 &&
-       (current_time - app->last_input_time) >= (DECODE_TIMEOUT_MS / 1000) &&
+       (current_time - app->last_input_time) >= DECODE_TIMEOUT_MS * 1000u &&
        app->current_morse_position > 0) {
 
         // Null terminate the current morse code
@@ -341,9 +1353,11 @@ static void try_decode_morse(MorseApp* app) {
 
         // Store the last decoded character (regardless of validity)
         app->last_decoded_char = decoded;
+        stats_add_characters(app, 1, 1, decoded != MORSE_UNKNOWN);
+        if(app->screen_off) play_cue(app, decoded != MORSE_UNKNOWN);
 
         // If we got a valid character, add it to the decoded text
-        if(decoded != '?') {
+        if(decoded != MORSE_UNKNOWN) {
             // Add to decoded_text (used for internal tracking, limited by MAX_MORSE_LENGTH)
             size_t len = strlen(app->decoded_text);
             if(len < MAX_MORSE_LENGTH - 1) {
@@ -356,6 +1370,7 @@ static void try_decode_morse(MorseApp* app) {
 
             // Update the top_words marquee (this handles the marquee effect)
             update_top_words_marquee(app, decoded);
+            command_feed(app, decoded);
 
             // Copy the decoded character to user_input display
             if (app->input_position < MAX_MORSE_LENGTH - 1) {
@@ -370,118 +1385,3037 @@ static void try_decode_morse(MorseApp* app) {
     }
 }
 
-// Draw application UI based on current state
-static void morse_app_draw_callback(Canvas* canvas, void* ctx) {
-    MorseApp* app = ctx;
-    if(!app || !canvas) return;
+// Key a schedule with absolute tick deadlines so rounding never accumulates.
+// Returns false if aborted.
+static bool play_schedule(MorseApp* app, const MorseSchedule* schedule, bool gpio, volatile bool* abort) {
+    if(!furi_hal_speaker_acquire(1000)) return false;
 
-    canvas_clear(canvas);
-    // Make background black
-    canvas_set_color(canvas, ColorBlack);
-    canvas_draw_box(canvas, 0, 0, 128, 64);
-    canvas_draw_icon(canvas, 0, 45, &I_menu_bg);
+    uint32_t deadline = furi_get_tick();
+    bool completed = true;
 
-    switch(app->app_state) {
-        case MorseStateTitleScreen:
-            canvas_draw_icon(canvas, 0, 0, &I_title_screen);
+    for(uint16_t i = 0; i < schedule->count; i++) {
+        if(abort && *abort) {
+            completed = false;
             break;
+        }
 
-        case MorseStateMenu: {
-            canvas_draw_icon(canvas, 0, 45, &I_menu_bg);
-            canvas_draw_icon(canvas, 4, 5, &I_wood);
-
-            // Define menu items and their corresponding titles
-            const char* menu_titles[] = {"Learn", "Practice", "Help"};
-
-            // Display title based on current selection at the top
-            canvas_set_font(canvas, FontPrimary);
-            canvas_set_color(canvas, ColorBlack);
-            canvas_draw_str_aligned(canvas, 64, 12, AlignCenter, AlignCenter, menu_titles[app->menu_selection]);
+        int16_t element = schedule->elements[i];
+        bool key_down = element > 0;
 
-            const int16_t y_offset = 24;
-            canvas_draw_icon(canvas, 12, y_offset + (app->menu_selection==0?8:0), &I_learn);
-            canvas_draw_icon(canvas, 54, y_offset + (app->menu_selection==1?8:0), &I_practice);
-            canvas_draw_icon(canvas, 94, y_offset + (app->menu_selection==2?8:0), &I_parrot);
+        if(key_down) {
+            if(app->volume > 0.0f) furi_hal_speaker_start(DEFAULT_FREQUENCY, app->volume);
+            if(gpio) furi_hal_gpio_write(&FOX_KEY_PIN, true);
+        }
+        if(app->bench.edges) app->bench.edges[i] = morse_clock_us();
 
-            const int16_t hand_y_offset = 46;
-            canvas_draw_icon(canvas, -15+app->menu_selection*40, hand_y_offset, &I_hand_left);
-            canvas_draw_icon(canvas, +35+app->menu_selection*40, hand_y_offset, &I_hand_right);
+        deadline += furi_ms_to_ticks(key_down ? element : -element);
+        furi_delay_until_tick(deadline);
 
-            break;
+        if(key_down) {
+            if(app->volume > 0.0f) furi_hal_speaker_stop();
+            if(gpio) furi_hal_gpio_write(&FOX_KEY_PIN, false);
         }
+    }
 
-        case MorseStateLearn: {
-            canvas_draw_icon(canvas, 20, 22, &I_learning_bg);
+    furi_hal_speaker_release();
+    return completed;
+}
 
-            canvas_draw_icon(canvas, 10, 36, &I_left);
-            canvas_draw_icon(canvas, 110, 36, &I_right);
+// Seconds from now to the start of this fox's next slot (never zero)
+static uint32_t fox_seconds_to_slot(const FoxHunt* fox, const DateTime* now) {
+    uint32_t cycle_minute = (now->hour * 60u + now->minute) % fox->foxes;
+    uint32_t slot_minute = fox->number % fox->foxes;  // Fox N keys during minute N mod foxes
+    uint32_t minutes = (slot_minute + fox->foxes - cycle_minute) % fox->foxes;
+    uint32_t seconds = minutes * 60u;
 
-            canvas_draw_icon(canvas, 50, 10, &I_up);
-            canvas_draw_icon(canvas, 70, 10, &I_down);
+    if(seconds <= now->second) seconds += fox->foxes * 60u;
+    return seconds - now->second;
+}
 
+// Fox worker: sleeps between slots, aligns to the RTC second boundary and keys the ID
+// for the whole slot. Every wait is recomputed from the RTC, so nothing drifts over a day.
+static int32_t fox_worker_thread(void* context) {
+    MorseApp* app = (MorseApp*)context;
+    FoxHunt* fox = &app->fox;
 
-            canvas_set_font(canvas, FontPrimary);
+    while(!fox->stop) {
+        DateTime now;
+        furi_hal_rtc_get_datetime(&now);
+        uint32_t seconds = fox_seconds_to_slot(fox, &now);
 
-            // Display current character
-            char txt[32];
-            snprintf(txt, sizeof(txt), "%c", app->current_char);
-            canvas_draw_str(canvas, 40, 40, txt);
+        if(seconds > FOX_ALIGN_WINDOW_S) {
+            // Plain sleep, woken early only by the stop flag
+            uint32_t flags = furi_thread_flags_wait(
+                FOX_FLAG_STOP, FuriFlagWaitAny, (seconds - FOX_ALIGN_WINDOW_S) * 1000);
+            if(!(flags & FuriFlagError) && (flags & FOX_FLAG_STOP)) break;
+            continue;
+        }
 
-            // Display Morse code
-            const char* morse = get_morse_for_char(app->current_char);
-            snprintf(txt, sizeof(txt), "%s", morse ? morse : "");
-            canvas_draw_str(canvas, 67, 40, txt);
+        // Last second before the slot: wait for the RTC second to roll over
+        uint8_t second = now.second;
+        while(!fox->stop) {
+            furi_delay_ms(1);
+            furi_hal_rtc_get_datetime(&now);
+            if(now.second != second && --seconds == 0) break;
+            second = now.second;
+        }
+        if(fox->stop) break;
 
-            canvas_set_color(canvas, ColorWhite);
-            canvas_draw_str(canvas, 28, 16, "A-Z");
-            canvas_draw_str(canvas, 80, 16, "0-9");
-            break;
+        // Slot start: key the ID back to back until the slot is nearly over
+        uint32_t slot_end = furi_get_tick() + furi_ms_to_ticks(FOX_SLOT_SECONDS * 1000 - FOX_SLOT_GUARD_MS);
+        uint32_t id_ms = 0;
+        for(uint16_t i = 0; i < fox->schedule.count; i++) {
+            int16_t element = fox->schedule.elements[i];
+            id_ms += (element > 0) ? element : -element;
         }
 
-        case MorseStatePractice: {
+        fox->on_air = true;
+        morse_view_update(app);
+        while(!fox->stop && (int32_t)(slot_end - furi_get_tick()) >= (int32_t)furi_ms_to_ticks(id_ms)) {
+            play_schedule(app, &fox->schedule, fox->gpio, &fox->stop);
+        }
+        fox->on_air = false;
+        morse_view_update(app);
+    }
 
-            canvas_draw_icon(canvas, 5, 15, &I_ball);
-            canvas_draw_icon(canvas, 0, 56, &I_desk);
+    return 0;
+}
 
-            // Show the appropriate beep icon and hand position based on input state
-            if(app->input_active) {
-                // When inputting: show beep_on and move hand down by 6px
-                canvas_draw_icon(canvas, 47, 34, &I_beep_on);
-                canvas_draw_icon(canvas, 80, 19, &I_hand); // Hand moved down by 6px
-            } else {
-                // Normal state: show beep_off and hand in normal position
-                canvas_draw_icon(canvas, 47, 34, &I_beep_off);
-                canvas_draw_icon(canvas, 80, 13, &I_hand); // Normal position
-            }
+// Encode the ID and start the fox worker
+static void fox_start(MorseApp* app) {
+    FoxHunt* fox = &app->fox;
+    if(fox->running) return;
 
-            canvas_draw_icon(canvas, 114, 52, &I_vol_bg);
+    // The ID repeats back to back, so end it with a word gap
+    char id[8];
+    snprintf(id, sizeof(id), "%s ", FOX_IDS[fox->number - 1]);
+    encode_schedule(&fox->schedule, id, fox->wpm);
+
+    if(fox->gpio) {
+        furi_hal_gpio_init_simple(&FOX_KEY_PIN, GpioModeOutputPushPull);
+        furi_hal_gpio_write(&FOX_KEY_PIN, false);
+    }
+
+    fox->stop = false;
+    fox->on_air = false;
+    fox->thread = furi_thread_alloc_ex("MorseFoxWorker", 1024, fox_worker_thread, app);
+    furi_thread_start(fox->thread);
+    fox->running = true;
+}
+
+// Stop the fox worker and release the key pin
+static void fox_stop(MorseApp* app) {
+    FoxHunt* fox = &app->fox;
+    if(!fox->running) return;
+
+    fox->stop = true;
+    furi_thread_flags_set(furi_thread_get_id(fox->thread), FOX_FLAG_STOP);
+    furi_thread_join(fox->thread);
+    furi_thread_free(fox->thread);
+    fox->thread = NULL;
+    fox->running = false;
+
+    if(fox->gpio) {
+        furi_hal_gpio_write(&FOX_KEY_PIN, false);
+        furi_hal_gpio_init_simple(&FOX_KEY_PIN, GpioModeAnalog);
+    }
+}
+
+// Collect decoded characters of a timing recording
+static void stream_decoded_callback(char character, void* context) {
+    MorseStream* stream = context;
+    marquee_push(stream->text, STREAM_TEXT_SHOWN, character);
+    if(character != ' ') stream->characters++;
+}
+
+// Note the time from launch to the first keyed element once
+static void stream_mark_first_element(MorseStream* stream) {
+    if(stream->first_element_us >= 0) return;
+    stream->first_element_us = (int32_t)(morse_clock_us() - stream->launch_us);
+    FURI_LOG_I("MorseMaster", "First element keyed %ld us after launch", (long)stream->first_element_us);
+}
+
+// Schedule elements one character takes, as encode_units lays it out
+static uint16_t stream_element_cost(char c) {
+    if(c == ' ') return 1;
+    const char* code = get_morse_for_char(c);
+    return code ? 2 * strlen(code) + 1 : 0;
+}
+
+// Key one pre-encoded word of a text file. stream_text cuts pieces to fit a
+// schedule, so a word that still overflows is dropped rather than cut short.
+static void stream_key_word(MorseApp* app, const char* word) {
+    MorseStream* stream = &app->stream;
+    if(!encode_schedule(&stream->schedule, word, stream->wpm)) {
+        FURI_LOG_E("MorseMaster", "Word too long to key: %s", word);
+        return;
+    }
+    if(stream->schedule.count == 0) return;
+
+    stream_mark_first_element(stream);
+    play_schedule(app, &stream->schedule, false, &app->sound_abort);
+    for(size_t i = 0; word[i] != '\0'; i++) {
+        marquee_push(stream->text, STREAM_TEXT_SHOWN, word[i]);
+        if(word[i] != ' ') stream->characters++;
+    }
+    morse_view_update(app);
+}
+
+// Key a text file word by word through a fixed read buffer
+static void stream_text(MorseApp* app, File* file) {
+    char chunk[STREAM_CHUNK_SIZE];
+    char word[STREAM_WORD_MAX + 2];
+    size_t length = 0;
+    uint16_t elements = 0;              // Schedule elements the piece so far needs
+    size_t bytes;
+
+    while(!app->sound_abort && (bytes = storage_file_read(file, chunk, sizeof(chunk))) > 0) {
+        for(size_t i = 0; i < bytes && !app->sound_abort; i++) {
+            char c = chunk[i];
+            bool separator = (c == ' ' || c == '\n' || c == '\r' || c == '\t');
+
+            // A character that would overflow the schedule starts a new piece
+            uint16_t cost = separator ? 0 : stream_element_cost(toupper(c));
+            if(cost && elements + cost > SCHEDULE_MAX_ELEMENTS - 1) {
+                word[length] = '\0';
+                stream_key_word(app, word);
+                length = 0;
+                elements = 0;
+            }
+            if(cost) {
+                word[length++] = toupper(c);
+                elements += cost;
+            }
+            // Words end at whitespace, the trailing space makes it a word gap
+            if((separator && length > 0) || length == STREAM_WORD_MAX) {
+                if(separator) word[length++] = ' ';
+                word[length] = '\0';
+                stream_key_word(app, word);
+                length = 0;
+                elements = 0;
+            }
+        }
+    }
+
+    if(length > 0 && !app->sound_abort) {
+        word[length] = '\0';
+        stream_key_word(app, word);
+    }
+}
+
+// Replay one recorded duration on the speaker and feed it to the decoder.
+// Deadlines come from the running total so rounding to ticks never accumulates.
+static void stream_timing_element(MorseApp* app, int32_t duration_us, uint32_t start_tick, uint64_t* total_us) {
+    MorseStream* stream = &app->stream;
+    bool key_down = duration_us > 0;
+    uint32_t length_us = key_down ? (uint32_t)duration_us : (uint32_t)-duration_us;
+
+    if(key_down) {
+        stream_mark_first_element(stream);
+        if(app->volume > 0.0f) furi_hal_speaker_start(DEFAULT_FREQUENCY, app->volume);
+    }
+
+    *total_us += length_us;
+    furi_delay_until_tick(start_tick + furi_ms_to_ticks((uint32_t)(*total_us / 1000)));
+
+    if(key_down) {
+        if(app->volume > 0.0f) furi_hal_speaker_stop();
+        morse_filter_run(&stream->filter, true, length_us);
+    } else {
+        morse_filter_run(&stream->filter, false, length_us);
+        morse_view_update(app);
+    }
+}
+
+// Replay a timing recording: values of "RAW_Data:" (.sub) or "Timing:" (.mkt) lines,
+// signed microseconds with marks positive. Parsed in a single pass over fixed chunks.
+static void stream_timing(MorseApp* app, File* file) {
+    char chunk[STREAM_CHUNK_SIZE];
+    char key[12];
+    size_t key_length = 0;
+    bool line_start = true;
+    bool in_data = false;
+    bool in_number = false;
+    bool negative = false;
+    int32_t value = 0;
+    uint64_t total_us = 0;
+    size_t bytes;
+
+    if(!furi_hal_speaker_acquire(1000)) return;
+    uint32_t start_tick = furi_get_tick();
+
+    while(!app->sound_abort && (bytes = storage_file_read(file, chunk, sizeof(chunk))) > 0) {
+        for(size_t i = 0; i < bytes && !app->sound_abort; i++) {
+            char c = chunk[i];
+
+            if(in_data) {
+                if(c >= '0' && c <= '9') {
+                    value = value * 10 + (c - '0');
+                    in_number = true;
+                    continue;
+                }
+                if(in_number) {
+                    stream_timing_element(app, negative ? -value : value, start_tick, &total_us);
+                }
+                negative = (c == '-');
+                in_number = false;
+                value = 0;
+                if(c == '\n') {
+                    in_data = false;
+                    line_start = true;
+                    key_length = 0;
+                }
+                continue;
+            }
+
+            // Outside data lines only the key before ':' matters
+            if(c == '\n') {
+                line_start = true;
+                key_length = 0;
+            } else if(line_start && c == ':') {
+                key[key_length] = '\0';
+                in_data = (strcmp(key, "RAW_Data") == 0 || strcmp(key, "Timing") == 0);
+                line_start = false;
+            } else if(line_start) {
+                if(key_length < sizeof(key) - 1) {
+                    key[key_length++] = c;
+                } else {
+                    line_start = false;
+                }
+            }
+        }
+    }
+    if(in_number && !app->sound_abort) {
+        stream_timing_element(app, negative ? -value : value, start_tick, &total_us);
+    }
+
+    furi_hal_speaker_release();
+    morse_filter_flush(&app->stream.filter);
+    morse_decoder_flush(&app->stream.decoder);
+    FURI_LOG_I("MorseMaster", "Glitches suppressed: %lu", (unsigned long)app->stream.filter.suppressed);
+}
+
+// Sound worker side of MorseStateStream
+static void stream_run(MorseApp* app) {
+    MorseStream* stream = &app->stream;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, stream->path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        if(stream->kind == StreamKindText) {
+            stream_text(app, file);
+        } else {
+            stream_timing(app, file);
+        }
+    } else {
+        FURI_LOG_E("MorseMaster", "Failed to open %s", stream->path);
+        stream->failed = true;
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    stream->done = true;
+}
+
+// Read the pack header; returns the lesson count, 0 if there is no valid pack
+static uint16_t lesson_pack_count(File* file) {
+    LessonPackHeader header;
+    if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) return 0;
+    if(memcmp(header.magic, LESSON_PACK_MAGIC, sizeof(header.magic)) != 0) return 0;
+    if(header.version != LESSON_PACK_VERSION) return 0;
+    return header.lesson_count;
+}
+
+// Load the index entry and header of the selected lesson: one seek each
+static void lessons_load_selected(MorseApp* app) {
+    LessonBrowser* lessons = &app->lessons;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    lessons->lesson_count = 0;
+    if(storage_file_open(file, LESSON_PACK_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        uint16_t count = lesson_pack_count(file);
+        if(lessons->selected >= count) lessons->selected = 0;
+
+        uint32_t index_offset = sizeof(LessonPackHeader) + lessons->selected * sizeof(LessonIndexEntry);
+        if(count > 0 && storage_file_seek(file, index_offset, true) &&
+           storage_file_read(file, &lessons->entry, sizeof(LessonIndexEntry)) == sizeof(LessonIndexEntry) &&
+           storage_file_seek(file, lessons->entry.offset, true) &&
+           storage_file_read(file, &lessons->header, sizeof(LessonHeader)) == sizeof(LessonHeader)) {
+            lessons->lesson_count = count;
+        }
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Key drill elements straight from the file in dot units. Edges sit at rounded
+// multiples of the exact unit, as with encode_schedule, so no runtime encoding.
+static void lesson_play_elements(MorseApp* app, File* file, uint16_t element_count, uint8_t wpm) {
+    int8_t buffer[LESSON_BUFFER_SIZE];
+    uint32_t units = 0;
+    uint32_t start_tick = furi_get_tick();
+    if(wpm < MIN_WPM || wpm > MAX_WPM) wpm = STREAM_DEFAULT_WPM;
+
+    while(element_count > 0 && !app->sound_abort) {
+        uint16_t chunk = (element_count < LESSON_BUFFER_SIZE) ? element_count : LESSON_BUFFER_SIZE;
+        if(storage_file_read(file, buffer, chunk) != chunk) break;
+        element_count -= chunk;
+
+        for(uint16_t i = 0; i < chunk && !app->sound_abort; i++) {
+            bool key_down = buffer[i] > 0;
+            units += key_down ? buffer[i] : -buffer[i];
+
+            if(key_down && app->volume > 0.0f) furi_hal_speaker_start(DEFAULT_FREQUENCY, app->volume);
+            furi_delay_until_tick(start_tick + furi_ms_to_ticks((units * 1200 + wpm / 2) / wpm));
+            if(key_down && app->volume > 0.0f) furi_hal_speaker_stop();
+        }
+    }
+}
+
+// Sound worker side of MorseStateLessons: seek once to the lesson, then stream
+static void lesson_play(MorseApp* app) {
+    LessonBrowser* lessons = &app->lessons;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, LESSON_PACK_PATH, FSAM_READ, FSOM_OPEN_EXISTING) &&
+       storage_file_seek(file, lessons->entry.offset + sizeof(LessonHeader), true) &&
+       furi_hal_speaker_acquire(1000)) {
+        for(uint16_t d = 0; d < lessons->header.drill_count && !app->sound_abort; d++) {
+            LessonDrillHeader drill;
+            if(storage_file_read(file, &drill, sizeof(drill)) != sizeof(drill)) break;
+
+            // Show the text, skipping anything beyond the display buffer
+            uint16_t shown = (drill.text_length < LESSON_TEXT_MAX) ? drill.text_length : LESSON_TEXT_MAX;
+            if(storage_file_read(file, lessons->text, shown) != shown) break;
+            lessons->text[shown] = '\0';
+            if(shown < drill.text_length && !storage_file_seek(file, drill.text_length - shown, false)) break;
+            lessons->drill = d + 1;
+            morse_view_update(app);
+
+            lesson_play_elements(app, file, drill.element_count, lessons->header.target_wpm);
+        }
+        furi_hal_speaker_release();
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    lessons->drill = 0;
+}
+
+// Collect characters decoded from the audio input
+static void listen_decoded_callback(char character, void* context) {
+    MorseListener* listen = context;
+    marquee_push(listen->text, STREAM_TEXT_SHOWN, character);
+    marquee_push(listen->transcript, LISTEN_TRANSCRIPT_MAX, character);
+    if(character != ' ' || !listen->glossary) return;
+
+    // A word just ended: the text between this space and the one before
+    size_t end = strlen(listen->transcript) - 1;
+    size_t start = end;
+    while(start > 0 && listen->transcript[start - 1] != ' ') start--;
+    const MorseGloss* gloss = morse_gloss_lookup(listen->transcript + start, end - start);
+    if(gloss) {
+        listen->gloss = gloss;
+        listen->gloss_tick = furi_get_tick();
+    }
+}
+
+// Sample interrupt: collect the conversion started on the last update and start
+// the next, so the ISR never waits on the ADC. A conversion (16 x 260 cycles at
+// 64 MHz, 65 us) ends well inside the 250 us period. Every sample is one period
+// late, which leaves the grid, the timer's, untouched. A block is handed to the
+// worker every TONE_BLOCK_SIZE samples.
+static void listen_sample_isr(void* context) {
+    MorseListener* listen = context;
+    if(!LL_TIM_IsActiveFlag_UPDATE(LISTEN_TIMER)) return;
+    LL_TIM_ClearFlag_UPDATE(LISTEN_TIMER);
+
+    listen->blocks[listen->filling][listen->filled++] = LL_ADC_REG_ReadConversionData12(LISTEN_ADC);
+    LL_ADC_REG_StartConversion(LISTEN_ADC);
+    if(listen->filled == TONE_BLOCK_SIZE) {
+        listen->ready = listen->filling;
+        listen->filling ^= 1;
+        listen->filled = 0;
+        furi_thread_flags_set(furi_thread_get_id(listen->thread), LISTEN_FLAG_BLOCK);
+    }
+}
+
+// Timer at 1 MHz reloading every sample; the caller checks nobody holds it
+static void listen_timer_start(MorseListener* listen) {
+    furi_hal_bus_enable(FuriHalBusTIM2);
+
+    LL_TIM_SetPrescaler(LISTEN_TIMER, furi_hal_cortex_instructions_per_microsecond() - 1);
+    LL_TIM_SetAutoReload(LISTEN_TIMER, LISTEN_SAMPLE_US - 1);
+    LL_TIM_GenerateEvent_UPDATE(LISTEN_TIMER);  // Loads the prescaler now
+    LL_TIM_ClearFlag_UPDATE(LISTEN_TIMER);
+
+    // One blocking read selects the channel, then the first conversion is left running
+    furi_hal_adc_read(listen->adc, LISTEN_ADC_CHANNEL);
+    LL_ADC_REG_StartConversion(LISTEN_ADC);
+
+    listen->filling = 0;
+    listen->filled = 0;
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdTIM2, listen_sample_isr, listen);
+    LL_TIM_EnableIT_UPDATE(LISTEN_TIMER);
+    LL_TIM_EnableCounter(LISTEN_TIMER);
+}
+
+static void listen_timer_stop(void) {
+    LL_TIM_DisableCounter(LISTEN_TIMER);
+    LL_TIM_DisableIT_UPDATE(LISTEN_TIMER);
+    furi_hal_interrupt_set_isr(FuriHalInterruptIdTIM2, NULL, NULL);
+    furi_hal_bus_disable(FuriHalBusTIM2);
+    // The last conversion, at most 65 us, ends before the ADC is released
+    while(LL_ADC_REG_IsConversionOngoing(LISTEN_ADC)) {
+    }
+}
+
+// Listen worker: sleeps until the sample interrupt hands over a block, runs
+// the tone detector on it and turns key edges into decoder marks and spaces.
+// The load shown is the time awake per block, which rises while a tone is
+// locked and keyed, so it is measured rather than guessed.
+static int32_t listen_worker_thread(void* context) {
+    MorseApp* app = (MorseApp*)context;
+    MorseListener* listen = &app->listen;
+    uint32_t block_cycles = LISTEN_BLOCK_US * furi_hal_cortex_instructions_per_microsecond();
+    bool key = false;
+    bool idle = true;                   // Last character and word already ended
+    uint32_t run = 0;                   // Blocks since the last key edge
+
+    while(!listen->stop) {
+        uint32_t flags = furi_thread_flags_wait(
+            LISTEN_FLAG_BLOCK | LISTEN_FLAG_STOP, FuriFlagWaitAny, FuriWaitForever);
+        if((flags & FuriFlagError) || (flags & LISTEN_FLAG_STOP)) break;
+
+        // The cycle counter halts in sleep, but the worker is awake throughout
+        uint32_t start = furi_hal_cortex_timer_get(0).start;
+        bool down = morse_tone_process(&listen->tone, listen->blocks[listen->ready]);
+        if(down != key) {
+            if(key) {
+                morse_filter_run(&listen->filter, true, run * LISTEN_BLOCK_US);
+            } else if(!idle) {
+                morse_filter_run(&listen->filter, false, run * LISTEN_BLOCK_US);
+            }
+            key = down;
+            idle = false;
+            run = 0;
+        }
+        run++;
+
+        // End the last character and word without waiting for another mark
+        if(!key && !idle && run * LISTEN_BLOCK_US >= 7 * listen->decoder.dot_us) {
+            morse_filter_run(&listen->filter, false, run * LISTEN_BLOCK_US);
+            morse_filter_flush(&listen->filter);
+            idle = true;
+        }
+        listen->key = key;
+        listen->dsp_load = (uint8_t)(100ull * (furi_hal_cortex_timer_get(0).start - start) / block_cycles);
+    }
+
+    return 0;
+}
+
+// Claim the ADC pin and sample timer and start the listen worker
+static void listen_start(MorseApp* app) {
+    MorseListener* listen = &app->listen;
+    if(listen->running) return;
+    listen->timer_busy = furi_hal_bus_is_enabled(FuriHalBusTIM2);
+    if(listen->timer_busy) return;
+
+    morse_tone_init(&listen->tone);
+    morse_decoder_init(&listen->decoder, DECODER_DEFAULT_WPM, listen_decoded_callback, listen);
+    if(app->resume.captured.dot_us) listen->decoder.dot_us = app->resume.captured.dot_us;
+    morse_filter_init(&listen->filter, &listen->decoder, app->filter_percent);
+    memset(listen->text, 0, sizeof(listen->text));
+    memset(listen->transcript, 0, sizeof(listen->transcript));
+    listen->glossary = app->glossary;
+    listen->gloss = NULL;
+    listen->key = false;
+    listen->dsp_load = 0;
+
+    furi_hal_gpio_init(&LISTEN_PIN, GpioModeAnalog, GpioPullNo, GpioSpeedVeryHigh);
+    listen->adc = furi_hal_adc_acquire();
+    // 16x oversampling keeps a conversion short enough for the sample period;
+    // the default 64x takes longer than one
+    furi_hal_adc_configure_ex(
+        listen->adc, FuriHalAdcScale2048, FuriHalAdcClockSync64, FuriHalAdcOversample16, FuriHalAdcSamplingtime247_5);
+
+    listen->stop = false;
+    listen->thread = furi_thread_alloc_ex("MorseListenWorker", 1024, listen_worker_thread, app);
+    furi_thread_start(listen->thread);
+
+    // The timer stops in deep sleep, so hold the core in light sleep instead
+    furi_hal_power_insomnia_enter();
+    listen_timer_start(listen);
+    listen->running = true;
+}
+
+// Stop the listen worker and release the ADC
+static void listen_stop(MorseApp* app) {
+    MorseListener* listen = &app->listen;
+    if(!listen->running) return;
+
+    listen_timer_stop();
+    furi_hal_power_insomnia_exit();
+    listen->stop = true;
+    furi_thread_flags_set(furi_thread_get_id(listen->thread), LISTEN_FLAG_STOP);
+    furi_thread_join(listen->thread);
+    furi_thread_free(listen->thread);
+    listen->thread = NULL;
+    furi_hal_adc_release(listen->adc);
+    listen->adc = NULL;
+    listen->running = false;
+}
+
+// True if path ends with the given extension, case-insensitive
+static bool path_has_extension(const char* path, const char* extension) {
+    size_t path_length = strlen(path);
+    size_t extension_length = strlen(extension);
+    if(path_length < extension_length) return false;
+    return strcasecmp(path + path_length - extension_length, extension) == 0;
+}
+
+// Apply the launch argument: a file path to stream or a mode name to open.
+// Returns false if the argument was not understood.
+static bool apply_launch_argument(MorseApp* app, const char* args) {
+    if(path_has_extension(args, ".txt") || path_has_extension(args, ".sub") || path_has_extension(args, ".mkt")) {
+        MorseStream* stream = &app->stream;
+        strncpy(stream->path, args, STREAM_PATH_MAX - 1);
+        stream->path[STREAM_PATH_MAX - 1] = '\0';
+        stream->kind = path_has_extension(args, ".txt") ? StreamKindText : StreamKindTiming;
+        enter_state(app, MorseStateStream);
+        return true;
+    }
+
+    for(size_t i = 0; i < COUNT_OF(LAUNCH_MODES); i++) {
+        if(strcasecmp(args, LAUNCH_MODES[i].name) == 0) {
+            enter_state(app, LAUNCH_MODES[i].state);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Queue a pre-encoded schedule on the sound worker
+static void play_schedule_async(MorseApp* app, const MorseSchedule* schedule) {
+    app->sound_schedule = schedule;
+    app->sound_abort = false;
+    app->sound_busy = true;
+    SoundCommand cmd = SoundCommandSchedule;
+    if(furi_message_queue_put(app->sound_queue, &cmd, 0) != FuriStatusOk) {
+        app->sound_busy = false;
+    }
+}
+
+// Generate and pre-encode every group of the current step before any of it plays
+static void ladder_prepare_step(MorseApp* app) {
+    LadderTest* ladder = &app->ladder;
+
+    for(int g = 0; g < LADDER_GROUPS_PER_STEP; g++) {
+        for(int i = 0; i < LADDER_GROUP_SIZE; i++) {
+            ladder->groups[g][i] = MORSE_TABLE[morse_charset_sample(LADDER_CHARSET, &app->rng)].character;
+        }
+        ladder->groups[g][LADDER_GROUP_SIZE] = '\0';
+        encode_schedule(&ladder->schedules[g], ladder->groups[g], ladder->wpm);
+    }
+    ladder->group = 0;
+}
+
+// Play the current group
+static void ladder_play_group(MorseApp* app) {
+    app->ladder.phase = LadderPhasePlaying;
+    play_schedule_async(app, &app->ladder.schedules[app->ladder.group]);
+}
+
+// Read the most recent results from the history file
+static void ladder_load_history(MorseApp* app) {
+    LadderTest* ladder = &app->ladder;
+    ladder->history_count = 0;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, LADDER_HISTORY_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        uint64_t records = storage_file_size(file) / sizeof(LadderRecord);
+        uint8_t count = (records < LADDER_HISTORY_SHOWN) ? (uint8_t)records : LADDER_HISTORY_SHOWN;
+
+        // Fixed-size records: seek straight to the tail
+        if(count > 0 && storage_file_seek(file, (uint32_t)((records - count) * sizeof(LadderRecord)), true)) {
+            size_t bytes = storage_file_read(file, ladder->history, count * sizeof(LadderRecord));
+            ladder->history_count = (uint8_t)(bytes / sizeof(LadderRecord));
+        }
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Append the finished test to the history file
+static void ladder_save_result(MorseApp* app) {
+    LadderTest* ladder = &app->ladder;
+    LadderRecord record = {
+        .timestamp = furi_hal_rtc_get_timestamp(),
+        .seed = app->session_seed,
+        .base_wpm = ladder->base_wpm,
+        .max_wpm = ladder->best_wpm,
+        .misses = ladder->max_misses,
+        .step_wpm = ladder->step_wpm,
+    };
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, MORSE_DATA_DIR);
+    File* file = storage_file_alloc(storage);
+    if(!storage_file_open(file, LADDER_HISTORY_PATH, FSAM_WRITE, FSOM_OPEN_APPEND) ||
+       storage_file_write(file, &record, sizeof(record)) != sizeof(record)) {
+        FURI_LOG_E("MorseMaster", "Failed to save ladder result");
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Finish the test, keep the result and refresh the shown history
+static void ladder_finish(MorseApp* app) {
+    app->ladder.phase = LadderPhaseDone;
+    ladder_save_result(app);
+    ladder_load_history(app);
+}
+
+// Start a test at the base speed with a fresh session seed
+static void ladder_start(MorseApp* app) {
+    LadderTest* ladder = &app->ladder;
+    start_session(app, furi_hal_rtc_get_timestamp() ^ furi_get_tick());
+    ladder->wpm = ladder->base_wpm;
+    ladder->best_wpm = 0;
+    ladder->copied = 0;
+    ladder->misses = 0;
+    ladder_prepare_step(app);
+    ladder_play_group(app);
+}
+
+// Apply the user's own verdict on the group just played. A speed is passed
+// after LADDER_COPIES_TO_PASS copies and failed after max_misses misses, both
+// counted afresh at each step, so one lucky group never sets the result.
+static void ladder_grade(MorseApp* app, bool copied) {
+    LadderTest* ladder = &app->ladder;
+    stats_add_characters(app, LADDER_GROUP_SIZE, LADDER_GROUP_SIZE, copied ? LADDER_GROUP_SIZE : 0);
+
+    if(copied && ++ladder->copied >= LADDER_COPIES_TO_PASS) {
+        stats_add_wpm(app, ladder->wpm);
+        ladder->best_wpm = ladder->wpm;
+        if(ladder->wpm + ladder->step_wpm > MAX_WPM) {
+            ladder_finish(app);
+            return;
+        }
+        ladder->wpm += ladder->step_wpm;
+        ladder->copied = 0;
+        ladder->misses = 0;
+        ladder_prepare_step(app);
+    } else {
+        if(!copied && ++ladder->misses >= ladder->max_misses) {
+            ladder_finish(app);
+            return;
+        }
+        // Next group at the same speed, a fresh batch once the step runs out
+        if(++ladder->group >= LADDER_GROUPS_PER_STEP) {
+            ladder_prepare_step(app);
+        }
+    }
+
+    ladder_play_group(app);
+}
+
+// Days since 1970 by the RTC, the key of a statistics record
+static uint32_t stats_current_day(void) {
+    return furi_hal_rtc_get_timestamp() / STATS_SECONDS_PER_DAY;
+}
+
+static bool stats_header_valid(const StatsHeader* header) {
+    return memcmp(header->magic, STATS_MAGIC, sizeof(header->magic)) == 0 && header->version == STATS_VERSION &&
+           header->record_size == sizeof(DailyStats);
+}
+
+static uint32_t stats_record_offset(const StatsHeader* header, uint32_t day) {
+    return sizeof(StatsHeader) + (day - header->first_day) * sizeof(DailyStats);
+}
+
+// Pick up today's record, in case the app already ran today
+static void stats_load(MorseApp* app) {
+    StatsTracker* stats = &app->stats;
+    memset(&stats->today, 0, sizeof(stats->today));
+    stats->dirty = false;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    StatsHeader header;
+    if(storage_file_open(file, STATS_PATH, FSAM_READ, FSOM_OPEN_EXISTING) &&
+       storage_file_read(file, &header, sizeof(header)) == sizeof(header) && stats_header_valid(&header) &&
+       stats->day >= header.first_day &&
+       storage_file_size(file) >= stats_record_offset(&header, stats->day) + sizeof(DailyStats) &&
+       storage_file_seek(file, stats_record_offset(&header, stats->day), true)) {
+        storage_file_read(file, &stats->today, sizeof(stats->today));
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Save worker side: write a day's record in place, zero-filling any days
+// skipped since the last one
+static void stats_write(MorseApp* app, uint32_t day, const DailyStats* today) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, MORSE_DATA_DIR);
+    File* file = storage_file_alloc(storage);
+    StatsHeader header;
+    bool ok = storage_file_open(file, STATS_PATH, FSAM_READ_WRITE, FSOM_OPEN_ALWAYS);
+
+    if(ok && storage_file_size(file) < sizeof(header)) {
+        memcpy(header.magic, STATS_MAGIC, sizeof(header.magic));
+        header.version = STATS_VERSION;
+        header.record_size = sizeof(DailyStats);
+        header.first_day = day;
+        ok = storage_file_write(file, &header, sizeof(header)) == sizeof(header);
+    } else if(ok) {
+        ok = storage_file_read(file, &header, sizeof(header)) == sizeof(header) && stats_header_valid(&header) &&
+             day >= header.first_day;
+    }
+
+    if(ok) {
+        uint32_t offset = stats_record_offset(&header, day);
+        uint64_t size = storage_file_size(file);
+        ok = (size - sizeof(header)) % sizeof(DailyStats) == 0;
+        if(ok && size < offset) {
+            static const DailyStats empty[STATS_GAP_RECORDS];
+            ok = storage_file_seek(file, (uint32_t)size, true);
+            while(ok && size < offset) {
+                uint32_t bytes = offset - (uint32_t)size;
+                if(bytes > sizeof(empty)) bytes = sizeof(empty);
+                ok = storage_file_write(file, empty, bytes) == bytes;
+                size += bytes;
+            }
+        }
+        ok = ok && storage_file_seek(file, offset, true) &&
+             storage_file_write(file, today, sizeof(*today)) == sizeof(*today);
+    }
+
+    if(!ok) {
+        FURI_LOG_E("MorseMaster", "Failed to save daily statistics");
+        if(day == app->stats.day) app->stats.dirty = true;  // Tried again on the next save
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Fold in the training time and queue today's record if it changed
+static void stats_save(MorseApp* app) {
+    StatsTracker* stats = &app->stats;
+    uint32_t seconds = stats->today.seconds + stats->active_ms / 1000;
+    stats->today.seconds = (seconds > UINT16_MAX) ? UINT16_MAX : (uint16_t)seconds;
+    if(stats->active_ms >= 1000) stats->dirty = true;
+    stats->active_ms %= 1000;
+    if(!stats->dirty) return;
+
+    SaveJob job = {.type = SaveJobStats, .stats = {.day = stats->day, .today = stats->today}};
+    if(furi_message_queue_put(app->save_queue, &job, 0) == FuriStatusOk) stats->dirty = false;
+}
+
+// Close the day at midnight and start the next one
+static void stats_roll_day(MorseApp* app) {
+    uint32_t day = stats_current_day();
+    if(day == app->stats.day) return;
+
+    stats_save(app);
+    app->stats.day = day;
+    stats_load(app);
+}
+
+static uint16_t stats_saturating_add(uint16_t value, uint16_t add) {
+    return (value > UINT16_MAX - add) ? UINT16_MAX : value + add;
+}
+
+static void stats_add_characters(MorseApp* app, uint16_t characters, uint16_t graded, uint16_t correct) {
+    stats_roll_day(app);
+    DailyStats* today = &app->stats.today;
+    today->characters = stats_saturating_add(today->characters, characters);
+    today->graded = stats_saturating_add(today->graded, graded);
+    today->correct = stats_saturating_add(today->correct, correct);
+    app->stats.dirty = true;
+}
+
+static void stats_add_wpm(MorseApp* app, uint8_t wpm) {
+    stats_roll_day(app);
+    DailyStats* today = &app->stats.today;
+    if(today->wpm_samples == UINT16_MAX) return;
+    today->wpm_total += wpm;
+    today->wpm_samples++;
+    if(wpm > today->max_wpm) today->max_wpm = wpm;
+    app->stats.dirty = true;
+}
+
+static bool stats_training_state(MorseAppState state) {
+    return state == MorseStateLearn || state == MorseStatePractice || state == MorseStateLadder ||
+           state == MorseStateLessons || state == MorseStateListen || state == MorseStateEcho ||
+           state == MorseStateSend || state == MorseStateQso;
+}
+
+// Main loop side: training time, lesson drills played by the sound worker,
+// and a write-back whenever a mode is left for the menu
+static void stats_tick(MorseApp* app) {
+    StatsTracker* stats = &app->stats;
+    uint32_t now = furi_get_tick();
+    if(stats_training_state(app->app_state)) stats->active_ms += now - stats->last_tick;
+    stats->last_tick = now;
+
+    LessonBrowser* lessons = &app->lessons;
+    if(app->app_state == MorseStateLessons && lessons->drill != 0 && lessons->drill != stats->lesson_drill) {
+        uint16_t characters = 0;
+        for(const char* c = lessons->text; *c; c++) characters += (*c != ' ');
+        stats_add_characters(app, characters, 0, 0);
+        stats_add_wpm(app, lessons->header.target_wpm);
+    }
+    stats->lesson_drill = lessons->drill;
+
+    if(app->app_state != stats->last_state) {
+        if(app->app_state == MorseStateMenu) {
+            stats_roll_day(app);
+            stats_save(app);
+        }
+        stats->last_state = app->app_state;
+    }
+}
+
+// Screen on or off. Off blanks the display once, turns the backlight off and
+// from then on every redraw is skipped, so drawing costs nothing.
+static void screen_set(MorseApp* app, bool off) {
+    if(off == app->screen_off) return;
+    PowerMeter* power = &app->power;
+
+    if(off) {
+        view_port_update(app->view_port);
+        app->screen_off = true;
+        notification_message(app->notifications, &sequence_display_backlight_off);
+        power->shown_tick = 0;
+    } else {
+        app->screen_off = false;
+        notification_message(app->notifications, &sequence_display_backlight_on);
+        if(power->samples[0] > 0 && power->samples[1] > 0) {
+            float on_ma = power->sum_ma[0] / power->samples[0];
+            float off_ma = power->sum_ma[1] / power->samples[1];
+            power->saved_ma = (int32_t)(on_ma - off_ma + 0.5f);
+            power->shown_tick = furi_get_tick();
+            FURI_LOG_I(
+                "MorseMaster", "Battery draw %ld mA screen on, %ld mA off", (long)(on_ma + 0.5f),
+                (long)(off_ma + 0.5f));
+        }
+        view_port_update(app->view_port);
+    }
+    power->sample_tick = furi_get_tick();
+}
+
+// Main loop side: battery current while training, kept apart by screen state
+static void power_tick(MorseApp* app) {
+    PowerMeter* power = &app->power;
+    uint32_t now = furi_get_tick();
+
+    if(app->screen_off && !stats_training_state(app->app_state)) screen_set(app, false);
+    if(power->shown_tick && now - power->shown_tick >= POWER_SHOWN_MS) {
+        power->shown_tick = 0;
+        morse_view_update(app);
+    }
+
+    if(now - power->sample_tick < POWER_SAMPLE_MS) return;
+    power->sample_tick = now;
+    if(!stats_training_state(app->app_state)) return;
+
+    // Negative while discharging; nothing to compare while on USB power
+    float current_ma = -furi_hal_power_get_battery_current(FuriHalPowerICFuelGauge) * 1000.0f;
+    if(current_ma <= 0.0f) return;
+    power->sum_ma[app->screen_off] += current_ma;
+    power->samples[app->screen_off]++;
+}
+
+static uint16_t progress_metric(const DailyStats* record, ProgressMetric metric) {
+    switch(metric) {
+        case ProgressMetricCharacters:
+            return record->characters;
+        case ProgressMetricAccuracy:
+            return record->graded ? (uint16_t)(100u * record->correct / record->graded) : 0;
+        case ProgressMetricAverageWpm:
+            return record->wpm_samples ? (uint16_t)(record->wpm_total / record->wpm_samples) : 0;
+        case ProgressMetricMaxWpm:
+            return record->max_wpm;
+        default:
+            return (uint16_t)((record->seconds + 59) / 60);
+    }
+}
+
+// Read the shown days only: one seek to the first, then a few small reads.
+// Today comes from RAM, its record may still be queued for the save worker.
+static void progress_load(MorseApp* app) {
+    ProgressGraph* graph = &app->progress;
+    memset(graph->values, 0, sizeof(graph->values));
+    graph->empty = true;
+
+    stats_roll_day(app);
+    stats_save(app);
+    const DailyStats* today = &app->stats.today;
+    uint32_t last_day = app->stats.day;
+    uint32_t first_day = last_day + 1 - graph->days;
+    for(int m = 0; m < ProgressMetricCount; m++) {
+        graph->values[m][last_day - first_day] = progress_metric(today, m);
+    }
+    if(today->characters || today->seconds) graph->empty = false;
+    last_day--;  // The file holds the days before
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    StatsHeader header;
+    if(storage_file_open(file, STATS_PATH, FSAM_READ, FSOM_OPEN_EXISTING) &&
+       storage_file_read(file, &header, sizeof(header)) == sizeof(header) && stats_header_valid(&header) &&
+       last_day >= header.first_day) {
+        uint32_t day = (first_day > header.first_day) ? first_day : header.first_day;
+        if(storage_file_seek(file, stats_record_offset(&header, day), true)) {
+            DailyStats records[PROGRESS_READ_RECORDS];
+            while(day <= last_day) {
+                uint32_t wanted = last_day + 1 - day;
+                if(wanted > PROGRESS_READ_RECORDS) wanted = PROGRESS_READ_RECORDS;
+                size_t count = storage_file_read(file, records, wanted * sizeof(DailyStats)) / sizeof(DailyStats);
+                for(size_t i = 0; i < count; i++, day++) {
+                    for(int m = 0; m < ProgressMetricCount; m++) {
+                        graph->values[m][day - first_day] = progress_metric(&records[i], m);
+                    }
+                    if(records[i].characters || records[i].seconds) graph->empty = false;
+                }
+                if(count < wanted) break;
+            }
+        }
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static void confusion_load(MorseApp* app) {
+    memset(&app->confusion, 0, sizeof(app->confusion));
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    ConfusionHeader header;
+    if(storage_file_open(file, CONFUSION_PATH, FSAM_READ, FSOM_OPEN_EXISTING) &&
+       storage_file_read(file, &header, sizeof(header)) == sizeof(header)) {
+        // A matrix from a different table layout starts over
+        if(memcmp(header.magic, CONFUSION_MAGIC, sizeof(header.magic)) == 0 && header.version == CONFUSION_VERSION &&
+           header.rows == MORSE_TABLE_SIZE && header.columns == CONFUSION_COLUMNS &&
+           storage_file_read(file, &app->confusion, sizeof(app->confusion)) != sizeof(app->confusion)) {
+            memset(&app->confusion, 0, sizeof(app->confusion));
+        }
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Count one answer and write through only what changed: the cell, or the row
+// when it was halved. The whole matrix is written once when the file is new.
+static void confusion_record(MorseApp* app, char expected, char received) {
+    bool halved;
+    int row = morse_confusion_record(&app->confusion, expected, received, &halved);
+    if(row < 0) return;
+
+    int column = get_table_index_for_char(received);
+    if(column < 0) column = CONFUSION_COLUMNS - 1;
+    const uint8_t* counts = app->confusion.counts[row];
+    uint32_t offset = sizeof(ConfusionHeader) + row * CONFUSION_COLUMNS + (halved ? 0 : column);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, MORSE_DATA_DIR);
+    File* file = storage_file_alloc(storage);
+    bool ok = storage_file_open(file, CONFUSION_PATH, FSAM_READ_WRITE, FSOM_OPEN_ALWAYS);
+    if(ok && storage_file_size(file) != sizeof(ConfusionHeader) + sizeof(MorseConfusion)) {
+        ConfusionHeader header = {.version = CONFUSION_VERSION, .rows = MORSE_TABLE_SIZE, .columns = CONFUSION_COLUMNS};
+        memcpy(header.magic, CONFUSION_MAGIC, sizeof(header.magic));
+        ok = storage_file_seek(file, 0, true) && storage_file_write(file, &header, sizeof(header)) == sizeof(header) &&
+             storage_file_write(file, &app->confusion, sizeof(app->confusion)) == sizeof(app->confusion);
+    } else if(ok) {
+        size_t bytes = halved ? CONFUSION_COLUMNS : 1;
+        ok = storage_file_seek(file, offset, true) &&
+             storage_file_write(file, halved ? counts : &counts[column], bytes) == bytes;
+    }
+    if(!ok) FURI_LOG_E("MorseMaster", "Failed to save confusion matrix");
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static MorseCharset learn_charset(const MorseApp* app) {
+    return (app->learn_set == LEARN_SET_CUSTOM) ? app->learn_custom : LEARN_SETS[app->learn_set].set;
+}
+
+// A character as a drill shows it: a prosign by name while the prosign set is
+// picked, and SK always, since '>' stands for nothing else. brackets gives
+// "<SK>", without them "SK" for tight columns.
+static void char_label(const MorseApp* app, char character, bool brackets, char* label, size_t size) {
+    const char* name = morse_prosign_name(character);
+    bool prosigns = app->learn_set != LEARN_SET_CUSTOM && LEARN_SETS[app->learn_set].set == MORSE_CHARSET_PROSIGNS;
+    if(name && (character == '>' || prosigns)) {
+        snprintf(label, size, brackets ? "<%s>" : "%s", name);
+    } else {
+        snprintf(label, size, "%c", character);
+    }
+}
+
+// The set UP (-1) or DOWN (+1) switches to, passing over an empty own set
+static uint8_t learn_set_step(const MorseApp* app, int direction) {
+    uint8_t set = app->learn_set;
+    do {
+        set = (uint8_t)((set + LEARN_SET_COUNT + direction) % LEARN_SET_COUNT);
+    } while(set == LEARN_SET_CUSTOM && app->learn_custom == 0);
+    return set;
+}
+
+static bool resume_slot_valid(const ResumeSnapshot* slot) {
+    return memcmp(slot->magic, RESUME_MAGIC, sizeof(slot->magic)) == 0 && slot->version == RESUME_VERSION &&
+           slot->size == sizeof(ResumeSnapshot) &&
+           slot->crc == morse_crc32(slot, offsetof(ResumeSnapshot, crc));
+}
+
+// Both slots in one read; returns false if neither holds a snapshot
+static bool resume_load(MorseApp* app) {
+    ResumeSnapshot slots[2];
+    memset(slots, 0, sizeof(slots));
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    if(storage_file_open(file, RESUME_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        storage_file_read(file, slots, sizeof(slots));
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    bool valid[2] = {resume_slot_valid(&slots[0]), resume_slot_valid(&slots[1])};
+    int newest = -1;
+    if(valid[0] && valid[1]) {
+        newest = (int32_t)(slots[1].sequence - slots[0].sequence) > 0 ? 1 : 0;
+    } else if(valid[0] || valid[1]) {
+        newest = valid[0] ? 0 : 1;
+    }
+    if(newest < 0) return false;
+
+    app->resume.written = slots[newest];
+    app->resume.captured = slots[newest];
+    return true;
+}
+
+static bool resume_state_supported(MorseAppState state) {
+    return state == MorseStateLearn || state == MorseStatePractice || state == MorseStateEcho ||
+           state == MorseStateListen;
+}
+
+// Put the loaded snapshot back; with enter_mode the app reopens the mode it was in
+static void resume_apply(MorseApp* app, bool enter_mode) {
+    const ResumeSnapshot* snapshot = &app->resume.written;
+
+    app->session_seed = snapshot->seed;
+    app->rng = snapshot->rng;
+    app->learn_custom = snapshot->learn_custom & MORSE_CHARSET_ALL;
+    if(snapshot->learn_set < LEARN_SET_COUNT) app->learn_set = snapshot->learn_set;
+    int index = get_table_index_for_char(snapshot->current_char);
+    if(index >= 0 && (learn_charset(app) & MORSE_CHARSET_BIT(index))) app->current_char = snapshot->current_char;
+    if(snapshot->echo_source < EchoSourceCount) app->echo.source = snapshot->echo_source;
+    FURI_LOG_I("MorseMaster", "Resumed session %08lX", (unsigned long)snapshot->seed);
+
+    MorseAppState state = snapshot->state;
+    if(enter_mode && resume_state_supported(state)) enter_state(app, state);
+
+    // Copied after entering the mode, which starts from a clean slate
+    app->last_decoded_char = snapshot->last_decoded_char;
+    app->auto_add_space = snapshot->auto_add_space;
+    memcpy(app->decoded_text, snapshot->decoded_text, sizeof(app->decoded_text));
+    memcpy(app->user_input, snapshot->user_input, sizeof(app->user_input));
+    memcpy(app->current_morse, snapshot->current_morse, sizeof(app->current_morse));
+    memcpy(app->top_words, snapshot->top_words, sizeof(app->top_words));
+    app->decoded_text[MAX_MORSE_LENGTH - 1] = '\0';
+    app->user_input[MAX_MORSE_LENGTH - 1] = '\0';
+    app->top_words[TOP_WORDS_MAX_LENGTH] = '\0';
+    app->input_position = (snapshot->input_position < MAX_MORSE_LENGTH) ? snapshot->input_position : 0;
+    app->current_morse_position =
+        (snapshot->morse_position < MAX_MORSE_LENGTH) ? snapshot->morse_position : 0;
+    app->current_morse[app->current_morse_position] = '\0';
+    if(app->current_morse_position > 0) app->last_input_time = morse_clock_us();
+
+    if(app->app_state == MorseStateEcho && snapshot->echo_anchor < MORSE_TABLE_SIZE) {
+        app->echo.anchor = snapshot->echo_anchor;
+        app->echo.round = snapshot->echo_round;
+        app->echo.right = snapshot->echo_right;
+        app->echo.total = snapshot->echo_total;
+    }
+}
+
+static void resume_capture(const MorseApp* app, ResumeSnapshot* snapshot) {
+    memset(snapshot, 0, sizeof(*snapshot));
+    memcpy(snapshot->magic, RESUME_MAGIC, sizeof(snapshot->magic));
+    snapshot->version = RESUME_VERSION;
+    snapshot->size = sizeof(ResumeSnapshot);
+    snapshot->seed = app->session_seed;
+    snapshot->rng = app->rng;
+    snapshot->dot_us = app->listen.running ? app->listen.decoder.dot_us : app->resume.captured.dot_us;
+    snapshot->state = app->app_state;
+    snapshot->learn_set = app->learn_set;
+    snapshot->learn_custom = app->learn_custom;
+    snapshot->current_char = app->current_char;
+    snapshot->last_decoded_char = app->last_decoded_char;
+    snapshot->auto_add_space = app->auto_add_space;
+    snapshot->echo_source = app->echo.source;
+    snapshot->echo_anchor = app->echo.anchor;
+    snapshot->echo_round = app->echo.round;
+    snapshot->echo_right = app->echo.right;
+    snapshot->echo_total = app->echo.total;
+    memcpy(snapshot->decoded_text, app->decoded_text, sizeof(snapshot->decoded_text));
+    memcpy(snapshot->user_input, app->user_input, sizeof(snapshot->user_input));
+    memcpy(snapshot->current_morse, app->current_morse, sizeof(snapshot->current_morse));
+    memcpy(snapshot->top_words, app->top_words, sizeof(snapshot->top_words));
+    snapshot->input_position = app->input_position;
+    snapshot->morse_position = app->current_morse_position;
+}
+
+// Save worker side: only a changed state is written, and only into the older
+// slot, one small write each time
+static void resume_write(MorseApp* app, const ResumeSnapshot* captured) {
+    SessionResume* resume = &app->resume;
+    ResumeSnapshot snapshot = *captured;
+    snapshot.sequence = resume->written.sequence;
+    snapshot.crc = resume->written.crc;
+    if(memcmp(&snapshot, &resume->written, sizeof(snapshot)) == 0) return;
+
+    snapshot.sequence++;
+    snapshot.crc = morse_crc32(&snapshot, offsetof(ResumeSnapshot, crc));
+    uint32_t offset = ((snapshot.sequence + 1) % 2) * sizeof(ResumeSnapshot);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, MORSE_DATA_DIR);
+    File* file = storage_file_alloc(storage);
+    bool ok = storage_file_open(file, RESUME_PATH, FSAM_WRITE, FSOM_OPEN_ALWAYS) &&
+              storage_file_seek(file, offset, true) &&
+              storage_file_write(file, &snapshot, sizeof(snapshot)) == sizeof(snapshot);
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+
+    // On failure the slot may be torn; the other one still holds the previous snapshot
+    if(ok) {
+        resume->written = snapshot;
+    } else {
+        FURI_LOG_E("MorseMaster", "Failed to save %s", RESUME_PATH);
+    }
+}
+
+// Main loop side. A snapshot is taken at most every RESUME_INTERVAL_MS and only
+// between keying, never with the key down or a schedule playing. A changed
+// state is queued for the save worker, which writes it.
+static void resume_tick(MorseApp* app, bool force) {
+    SessionResume* resume = &app->resume;
+    uint32_t now = furi_get_tick();
+    if(!force) {
+        if(now - resume->write_tick < RESUME_INTERVAL_MS) return;
+        if(app->input_active || app->keylog.key_down || app->sound_busy) return;
+        if(morse_clock_us() - app->keylog.edge_us < RESUME_IDLE_MS * 1000u) return;
+        if(now - app->echo.last_key_tick < RESUME_IDLE_MS) return;
+    }
+    resume->write_tick = now;
+
+    SaveJob job = {.type = SaveJobResume};
+    resume_capture(app, &job.resume);
+    if(memcmp(&job.resume, &resume->captured, sizeof(job.resume)) == 0) return;
+    if(furi_message_queue_put(app->save_queue, &job, 0) == FuriStatusOk) resume->captured = job.resume;
+}
+
+static const char* const ECHO_SOURCE_TITLES[EchoSourceCount] = {
+    "Echo: Learn set",
+    "Echo: confusions",
+    "Echo: similar",
+};
+
+// Random characters come from the set picked in Learn
+static MorseCharset echo_charset(const MorseApp* app) {
+    MorseCharset set = learn_charset(app);
+    return set ? set : LADDER_CHARSET;
+}
+
+// Similar codes: the anchor and one of its precomputed neighbours take turns,
+// then a neighbour becomes the next anchor. No work beyond two lookups.
+static char echo_next_similar(MorseApp* app) {
+    EchoDrill* echo = &app->echo;
+    uint8_t index = echo->anchor;
+    if(echo->round % 2) {
+        index = app->similarity.neighbours[echo->anchor][morse_rng_range(&app->rng, SIMILAR_NEIGHBOURS)];
+    }
+    if(++echo->round >= ECHO_SIMILAR_ROUNDS) {
+        echo->anchor = app->similarity.neighbours[echo->anchor][morse_rng_range(&app->rng, SIMILAR_NEIGHBOURS)];
+        echo->round = 0;
+    }
+    return MORSE_TABLE[index].character;
+}
+
+// Next character: any of the table, one side of a worst confused pair, or a
+// code close to the last ones
+static void echo_next(MorseApp* app) {
+    EchoDrill* echo = &app->echo;
+    MorseConfusionPair pairs[ECHO_DRILL_PAIRS];
+    uint8_t count = (echo->source == EchoSourceConfusions) ?
+                        morse_confusion_worst(&app->confusion, pairs, ECHO_DRILL_PAIRS) :
+                        0;
+
+    if(echo->source == EchoSourceSimilar) {
+        echo->target = echo_next_similar(app);
+    } else if(count > 0) {
+        const MorseConfusionPair* pair = &pairs[morse_rng_range(&app->rng, count)];
+        bool other = pair->received != MORSE_UNKNOWN && morse_rng_range(&app->rng, 2);
+        echo->target = other ? pair->received : pair->expected;
+    } else {
+        echo->target = MORSE_TABLE[morse_charset_sample(echo_charset(app), &app->rng)].character;
+    }
+
+    memset(echo->code, 0, sizeof(echo->code));
+    echo->code_length = 0;
+    echo->received = 0;
+    render_glyph(&echo->glyph, echo->code, GLYPH_ECHO_WIDTH);
+    play_character(app, echo->target);
+}
+
+static void echo_key(MorseApp* app, char element) {
+    EchoDrill* echo = &app->echo;
+    if(echo->received || echo->code_length >= MAX_MORSE_LENGTH - 1) return;
+
+    echo->code[echo->code_length++] = element;
+    echo->last_key_tick = furi_get_tick();
+    render_glyph(&echo->glyph, echo->code, GLYPH_ECHO_WIDTH);
+    if(element == '.') {
+        play_dot(app);
+    } else {
+        play_dash(app);
+    }
+}
+
+// Main loop side: grade after a pause, move on after the verdict
+static void echo_tick(MorseApp* app) {
+    EchoDrill* echo = &app->echo;
+    uint32_t now = furi_get_tick();
+
+    if(!echo->received && echo->code_length > 0 && now - echo->last_key_tick >= furi_ms_to_ticks(ECHO_PAUSE_MS)) {
+        echo->received = get_char_for_morse(echo->code);
+        bool right = echo->received == echo->target;
+        echo->total++;
+        if(right) echo->right++;
+        confusion_record(app, echo->target, echo->received);
+        stats_add_characters(app, 1, 1, right);
+        if(app->screen_off) play_cue(app, right);
+        echo->verdict_tick = now;
+        morse_view_update(app);
+    } else if(echo->received && now - echo->verdict_tick >= furi_ms_to_ticks(ECHO_VERDICT_MS)) {
+        echo_next(app);
+        morse_view_update(app);
+    }
+}
+
+static void keylog_push(KeyLog* log, int32_t duration_us) {
+    log->elements[log->written % KEYLOG_SIZE] = duration_us;
+    log->written++;
+}
+
+// Key handler side: a press closes the space before it, a release the mark
+static void keylog_edge(MorseApp* app, bool down) {
+    KeyLog* log = &app->keylog;
+    if(down == log->key_down) return;
+
+    uint32_t now = app->input_time_us;
+    uint32_t elapsed = now - log->edge_us;
+    if(!down) {
+        if(elapsed > KEYLOG_MAX_MARK_MS * 1000u) elapsed = KEYLOG_MAX_MARK_MS * 1000u;
+        keylog_push(log, elapsed > 0 ? (int32_t)elapsed : 1);
+    } else if(log->written != log->start) {
+        if(elapsed > KEYLOG_MAX_GAP_MS * 1000u) elapsed = KEYLOG_MAX_GAP_MS * 1000u;
+        keylog_push(log, -(int32_t)elapsed);
+    }
+    log->key_down = down;
+    log->edge_us = now;
+}
+
+// A new session starts where the last one ended; the save worker starts a new
+// file from the same point
+static void keylog_reset(MorseApp* app) {
+    KeyLog* log = &app->keylog;
+    log->start = log->written;
+    log->spill_queued = log->written;
+    log->key_down = false;
+    SaveJob job = {.type = SaveJobKeylogStart, .keylog_count = log->start};
+    furi_message_queue_put(app->save_queue, &job, FuriWaitForever);
+}
+
+// Main loop side: queue a spill once a line is complete, or whatever is left
+// with flush
+static void keylog_spill(MorseApp* app, bool flush) {
+    KeyLog* log = &app->keylog;
+    if(!log->spill) return;
+
+    uint32_t written = log->written;
+    if(written == log->spill_queued || (!flush && written - log->spill_queued < KEYLOG_SPILL_VALUES)) return;
+    SaveJob job = {.type = flush ? SaveJobKeylogFlush : SaveJobKeylog, .keylog_count = written};
+    if(furi_message_queue_put(app->save_queue, &job, 0) == FuriStatusOk) log->spill_queued = written;
+}
+
+// Save worker side: append whole "Timing:" lines in microseconds, the .mkt
+// layout a launch argument replays, up to written as it was when queued. flush
+// also writes a partial line.
+static void keylog_write(MorseApp* app, uint32_t written, bool flush) {
+    KeyLog* log = &app->keylog;
+    if(written - log->spilled > KEYLOG_SIZE) log->spilled = written - KEYLOG_SIZE;  // Overrun, the oldest are gone
+    if(written == log->spilled || (!flush && written - log->spilled < KEYLOG_SPILL_VALUES)) return;
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, MORSE_DATA_DIR);
+    File* file = storage_file_alloc(storage);
+    bool ok = storage_file_open(
+        file, PRACTICE_KEYLOG_PATH, FSAM_WRITE, log->spill_open ? FSOM_OPEN_APPEND : FSOM_CREATE_ALWAYS);
+    if(ok && !log->spill_open) {
+        const char* header = "Filetype: Morse Master Key Timing\nVersion: 1\n";
+        ok = storage_file_write(file, header, strlen(header)) == strlen(header);
+        log->spill_open = ok;
+    }
+
+    char line[8 + KEYLOG_SPILL_VALUES * 10];  // Values stay under 9 digits, marks and gaps are capped
+    while(ok && log->spilled < written) {
+        size_t length = snprintf(line, sizeof(line), "Timing:");
+        for(uint8_t i = 0; i < KEYLOG_SPILL_VALUES && log->spilled < written; i++, log->spilled++) {
+            length += snprintf(line + length, sizeof(line) - length, " %ld", (long)log->elements[log->spilled % KEYLOG_SIZE]);
+        }
+        line[length++] = '\n';
+        ok = storage_file_write(file, line, length) == length;
+    }
+    if(!ok) {
+        FURI_LOG_E("MorseMaster", "Failed to save practice keying");
+        log->spilled = written;
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Save worker: SD writes in the order they were queued, until SaveJobStop
+static int32_t save_worker_thread(void* context) {
+    MorseApp* app = (MorseApp*)context;
+    SaveJob job;
+    while(furi_message_queue_get(app->save_queue, &job, FuriWaitForever) == FuriStatusOk) {
+        if(job.type == SaveJobStop) break;
+        switch(job.type) {
+            case SaveJobKeylog:
+            case SaveJobKeylogFlush:
+                keylog_write(app, job.keylog_count, job.type == SaveJobKeylogFlush);
+                break;
+            case SaveJobKeylogStart:
+                app->keylog.spilled = job.keylog_count;
+                app->keylog.spill_open = false;
+                break;
+            case SaveJobStats:
+                stats_write(app, job.stats.day, &job.stats.today);
+                break;
+            case SaveJobResume:
+                resume_write(app, &job.resume);
+                break;
+            default:
+                break;
+        }
+    }
+    return 0;
+}
+
+static void review_decoded_callback(char character, void* context) {
+    SelfReview* review = context;
+    marquee_push(review->text, REVIEW_TEXT_MAX, character);
+}
+
+// Unroll the ring from its oldest mark and quantise it. The decoder is seeded
+// from the shortest mark, which is taken to be a dot.
+static void review_build(MorseApp* app) {
+    KeyLog* log = &app->keylog;
+    SelfReview* review = &app->review;
+    uint32_t written = log->written;
+    uint32_t first = (written - log->start > KEYLOG_SIZE) ? written - KEYLOG_SIZE : log->start;
+    if(first < written && log->elements[first % KEYLOG_SIZE] < 0) first++;
+
+    review->own.count = 0;
+    int32_t shortest = INT32_MAX;
+    for(uint32_t i = first; i < written; i++) {
+        int32_t element = log->elements[i % KEYLOG_SIZE];
+        review->own_us[review->own.count] = element;
+        review->own.elements[review->own.count++] = (int16_t)((element + (element > 0 ? 500 : -500)) / 1000);
+        if(element > 0 && element < shortest) shortest = element;
+    }
+    memset(review->text, 0, sizeof(review->text));
+    review->ideal.count = 0;
+    if(review->own.count == 0) return;
+
+    MorseDecoder decoder;
+    uint32_t seed_wpm = 1200000 / shortest;
+    if(seed_wpm < MIN_WPM) seed_wpm = MIN_WPM;
+    if(seed_wpm > MAX_WPM) seed_wpm = MAX_WPM;
+    morse_decoder_init(&decoder, (uint8_t)seed_wpm, review_decoded_callback, review);
+    review->wpm = morse_quantise_schedule(&review->ideal, review->own_us, review->own.count, &decoder);
+
+    // Where the fist departs from 1:3 marks and 1-dot gaps
+    uint32_t dot_us = 0, dots = 0, dash_us = 0, dashes = 0, gap_us = 0, gaps = 0;
+    for(uint16_t i = 0; i < review->own.count; i++) {
+        int32_t element = review->own_us[i];
+        switch(review->ideal.elements[i]) {
+            case 1:
+                dot_us += element;
+                dots++;
+                break;
+            case 3:
+                dash_us += element;
+                dashes++;
+                break;
+            case -1:
+                gap_us += -element;
+                gaps++;
+                break;
+            default:
+                break;
+        }
+    }
+    uint32_t average_dot = dots ? dot_us / dots : 1200000 / review->wpm;
+    review->dash_x10 = dashes ? (uint16_t)(10 * (dash_us / dashes) / average_dot) : 0;
+    review->gap_x10 = gaps ? (uint16_t)(10 * (gap_us / gaps) / average_dot) : 0;
+
+    schedule_units_to_ms(&review->ideal, review->wpm);
+}
+
+static void review_start(MorseApp* app, ReviewPlay request) {
+    if(app->sound_busy || app->review.own.count == 0) return;
+    app->review.request = request;
+    app->sound_abort = false;
+    app->sound_busy = true;
+    SoundCommand cmd = SoundCommandReview;
+    if(furi_message_queue_put(app->sound_queue, &cmd, 0) != FuriStatusOk) {
+        app->sound_busy = false;
+    }
+}
+
+// Sound worker side: both schedules go through the same deadline keying
+static void review_play(MorseApp* app) {
+    SelfReview* review = &app->review;
+    review->active = true;
+
+    bool completed = true;
+    if(review->request != ReviewPlayIdeal) {
+        review->playing = ReviewPlayOwn;
+        morse_view_update(app);
+        completed = play_schedule(app, &review->own, false, &app->sound_abort);
+    }
+    if(completed && review->request == ReviewPlayBoth) {
+        furi_delay_ms(REVIEW_PAUSE_MS);
+        completed = !app->sound_abort;
+    }
+    if(completed && review->request != ReviewPlayOwn) {
+        review->playing = ReviewPlayIdeal;
+        morse_view_update(app);
+        play_schedule(app, &review->ideal, false, &app->sound_abort);
+    }
+
+    review->active = false;
+}
+
+// Writer callback: append only, with the header when the file is new
+static bool qso_log_write(const char* data, size_t length, void* context) {
+    UNUSED(context);
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, MORSE_DATA_DIR);
+    File* file = storage_file_alloc(storage);
+
+    bool ok = storage_file_open(file, QSO_LOG_PATH, FSAM_WRITE, FSOM_OPEN_APPEND);
+    if(ok && storage_file_size(file) == 0) {
+        char header[96];
+        size_t header_length = adif_header(header, sizeof(header), "Morse Master");
+        ok = storage_file_write(file, header, header_length) == header_length;
+    }
+    ok = ok && storage_file_write(file, data, length) == length;
+    if(!ok) FURI_LOG_E("MorseMaster", "Failed to append to %s", QSO_LOG_PATH);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return ok;
+}
+
+// Text fields edited in place, NULL for the band
+static char* qso_log_text(QsoLog* log, LogField field, size_t* max) {
+    switch(field) {
+        case LogFieldCall:
+            *max = ADIF_CALL_MAX;
+            return log->qso.call;
+        case LogFieldSent:
+            *max = ADIF_RST_MAX;
+            return log->qso.rst_sent;
+        case LogFieldReceived:
+            *max = ADIF_RST_MAX;
+            return log->qso.rst_rcvd;
+        case LogFieldExchange:
+            *max = ADIF_EXCHANGE_MAX;
+            return log->qso.exchange;
+        default:
+            return NULL;
+    }
+}
+
+// New contact, prefilled from whatever was decoded last: Listen, then Practice
+static void qso_log_begin(MorseApp* app) {
+    QsoLog* log = &app->log;
+    memset(&log->qso, 0, sizeof(log->qso));
+    strcpy(log->qso.rst_sent, "599");
+    strcpy(log->qso.rst_rcvd, "599");
+    adif_prefill(&log->qso, app->listen.transcript[0] ? app->listen.transcript : app->decoded_text);
+    log->field = LogFieldCall;
+    log->editing = false;
+}
+
+static void qso_log_commit(MorseApp* app) {
+    QsoLog* log = &app->log;
+
+    // Spaces left by the editor are padding, not content
+    for(LogField field = 0; field < LogFieldCount; field++) {
+        size_t max;
+        char* text = qso_log_text(log, field, &max);
+        if(!text) continue;
+        size_t length = strlen(text);
+        while(length > 0 && text[length - 1] == ' ') text[--length] = '\0';
+    }
+
+    if(log->qso.call[0] == '\0') {
+        notification_message(app->notifications, &sequence_blink_red_100);
+        return;
+    }
+    log->qso.timestamp = furi_hal_rtc_get_timestamp();
+    strcpy(log->qso.band, ADIF_BANDS[log->band]);
+    if(!adif_writer_append(&log->writer, &log->qso)) {
+        notification_message(app->notifications, &sequence_blink_red_100);
+        return;
+    }
+    log->logged++;
+    notification_message(app->notifications, &sequence_blink_green_100);
+
+    // Ready for the next contact on the same band
+    memset(log->qso.call, 0, sizeof(log->qso.call));
+    memset(log->qso.exchange, 0, sizeof(log->qso.exchange));
+    log->field = LogFieldCall;
+}
+
+// Step the character under the cursor through LOG_EDIT_CHARSET
+static void qso_log_edit(QsoLog* log, int8_t step) {
+    size_t max;
+    char* text = qso_log_text(log, log->field, &max);
+    size_t length = strlen(text);
+    while(length <= log->cursor) text[length++] = ' ';
+    text[length] = '\0';
+
+    const char* charset = LOG_EDIT_CHARSET;
+    int count = (int)strlen(charset);
+    const char* current = strchr(charset, text[log->cursor]);
+    int index = current ? (int)(current - charset) : 0;
+    text[log->cursor] = charset[(index + step + count) % count];
+}
+
+// Keyboard side: returns false when the buffer is full
+static bool send_type(SendKeyer* send, char character) {
+    furi_mutex_acquire(send->mutex, FuriWaitForever);
+    bool room = send->head - send->tail < SEND_BUFFER_SIZE;
+    if(room) send->ring[send->head++ % SEND_BUFFER_SIZE] = character;
+    furi_mutex_release(send->mutex);
+    return room;
+}
+
+// Take back the newest character, unless the worker already has it
+static void send_delete(SendKeyer* send) {
+    furi_mutex_acquire(send->mutex, FuriWaitForever);
+    if(send->head != send->tail) send->head--;
+    furi_mutex_release(send->mutex);
+}
+
+// Copy of the newest unsent characters; returns the buffer depth
+static uint32_t send_unsent(SendKeyer* send, char* text, size_t max) {
+    furi_mutex_acquire(send->mutex, FuriWaitForever);
+    uint32_t depth = send->head - send->tail;
+    uint32_t first = (depth > max) ? send->head - max : send->tail;
+    size_t length = 0;
+    for(uint32_t i = first; i != send->head; i++) text[length++] = send->ring[i % SEND_BUFFER_SIZE];
+    furi_mutex_release(send->mutex);
+    text[length] = '\0';
+    return depth;
+}
+
+// Sound worker side: one character at a time, each encoded just before it keys.
+// Typing only ever waits for the mutex, the keying never does.
+static void send_run(MorseApp* app) {
+    SendKeyer* send = &app->send;
+    MorseSchedule schedule;
+
+    while(!app->sound_abort) {
+        char character = 0;
+        furi_mutex_acquire(send->mutex, FuriWaitForever);
+        if(send->tail != send->head) character = send->ring[send->tail++ % SEND_BUFFER_SIZE];
+        furi_mutex_release(send->mutex);
+
+        if(!character) {
+            if(send->drain) break;
+            furi_delay_ms(SEND_POLL_MS);
+            continue;
+        }
+
+        if(character == ' ') {
+            // The letter gap already followed the last character, add the rest of a word gap
+            schedule.count = 1;
+            schedule.elements[0] = -4;
+            schedule_units_to_ms(&schedule, send->wpm);
+        } else {
+            char single[2] = {character, '\0'};
+            encode_schedule(&schedule, single, send->wpm);
+        }
+
+        send->keying = character;
+        morse_view_update(app);
+        play_schedule(app, &schedule, false, &app->sound_abort);
+        marquee_push(send->sent, SEND_SENT_SHOWN, character);
+        send->keying = 0;
+        morse_view_update(app);
+    }
+}
+
+static const QsoRule QSO_RULES[] = {
+    {QsoBotAny, QSO_EVENT(QsoEventRepeat), QsoBotStay, 0, NULL},
+    {QsoBotAny, QSO_EVENT(QsoEventSlower), QsoBotStay, -QSO_QRS_STEP_WPM, NULL},
+    {QsoBotListening, QSO_EVENT(QsoEventCq), QsoBotCalled, 0, "$C $C"},
+    {QsoBotListening, QSO_EVENT(QsoEventCall), QsoBotReported, 0, "$O DE $C GM UR $R $R NAME $N $N HW KN"},
+    {QsoBotCalled, QSO_EVENT(QsoEventCall) | QSO_EVENT(QsoEventReport), QsoBotReported, 0,
+     "$O DE $C TNX UR $R $R NAME $N $N HW KN"},
+    {QsoBotCalled, QSO_EVENT(QsoEventCq), QsoBotCalled, 0, "$C $C"},
+    {QsoBotReported, QSO_EVENT(QsoEventReport) | QSO_EVENT(QsoEventCall), QsoBotClosing, 0,
+     "R TU $P 73 $O DE $C TU"},
+    {QsoBotReported, QSO_EVENT(QsoEventClose), QsoBotListening, 0, "TU 73 $O DE $C EE"},
+    {QsoBotClosing, QSO_EVENT(QsoEventClose) | QSO_EVENT(QsoEventCall), QsoBotListening, 0, "EE"},
+    {QsoBotClosing, QSO_EVENT(QsoEventCq), QsoBotCalled, 0, "$C $C"},
+};
+
+static const char* const QSO_PREFIXES[] = {"K", "W", "N", "AA", "KB", "WA", "G", "DL", "F", "VE", "JA", "EA"};
+static const char* const QSO_NAMES[] = {"BOB", "JIM", "ANN", "TOM", "SUE", "KEN", "JOE", "LIZ"};
+static const char* const QSO_REPORTS[] = {"5NN", "579", "589", "559"};
+
+static const char* const QSO_STATE_TITLES[QsoBotCount] = {
+    "Listening",
+    "Called",
+    "Report sent",
+    "Closing",
+};
+
+static void qso_decoded_callback(char character, void* context) {
+    MorseApp* app = context;
+    QsoBot* qso = &app->qso;
+    if(qso->over_length < QSO_OVER_MAX) {
+        qso->over[qso->over_length++] = character;
+        qso->over[qso->over_length] = '\0';
+    }
+    marquee_push(qso->heard, QSO_HEARD_SHOWN, character);
+    command_feed(app, character);
+}
+
+// A new station for every visit, drawn from the session generator
+static void qso_begin(MorseApp* app) {
+    QsoBot* qso = &app->qso;
+    morse_decoder_init(&qso->decoder, QSO_KEY_WPM, qso_decoded_callback, app);
+    morse_filter_init(&qso->filter, &qso->decoder, app->filter_percent);
+    qso->state = QsoBotListening;
+    qso->over_length = 0;
+    qso->over[0] = '\0';
+    memset(qso->heard, 0, sizeof(qso->heard));
+    qso->key_down = false;
+    qso->keyed = false;
+    qso->op_call[0] = '\0';
+    qso->op_name[0] = '\0';
+    qso->reply[0] = '\0';
+    qso->wpm = QSO_DEFAULT_WPM;
+
+    int length = snprintf(
+        qso->call, sizeof(qso->call), "%s%lu", QSO_PREFIXES[morse_rng_range(&app->rng, COUNT_OF(QSO_PREFIXES))],
+        (unsigned long)morse_rng_range(&app->rng, 10));
+    uint32_t suffix = 2 + morse_rng_range(&app->rng, 2);
+    for(uint32_t i = 0; i < suffix && length < ADIF_CALL_MAX; i++) {
+        qso->call[length++] = 'A' + morse_rng_range(&app->rng, 26);
+    }
+    qso->call[length] = '\0';
+    qso->name = QSO_NAMES[morse_rng_range(&app->rng, COUNT_OF(QSO_NAMES))];
+    qso->report = QSO_REPORTS[morse_rng_range(&app->rng, COUNT_OF(QSO_REPORTS))];
+    memset(app->send.sent, 0, sizeof(app->send.sent));
+}
+
+// Main loop side, like qso_tick: press and release times go straight to the decoder
+static void qso_edge(MorseApp* app, bool down) {
+    QsoBot* qso = &app->qso;
+    if(down == qso->key_down) return;
+
+    uint32_t now = app->input_time_us;
+    uint32_t elapsed_us = now - qso->edge_us;
+    if(!down) {
+        morse_filter_run(&qso->filter, true, elapsed_us);
+        qso->keyed = true;
+    } else if(qso->keyed) {
+        morse_filter_run(&qso->filter, false, elapsed_us);
+    }
+    qso->key_down = down;
+    qso->edge_us = now;
+}
+
+static uint8_t qso_classify(QsoBot* qso) {
+    uint8_t events = 0;
+    char token[QSO_OVER_MAX + 1];
+    bool name_next = false;
+    for(const char* word = qso->over; *word; word += strspn(word, " ")) {
+        size_t length = strcspn(word, " ");
+        memcpy(token, word, length);
+        token[length] = '\0';
+        word += length;
+        if(length == 0) continue;
+
+        if(strcmp(token, "?") == 0 || strcmp(token, "AGN") == 0 || strcmp(token, "RPT") == 0) {
+            events |= QSO_EVENT(QsoEventRepeat);
+        } else if(strcmp(token, "QRS") == 0) {
+            events |= QSO_EVENT(QsoEventSlower);
+        } else if(strcmp(token, "CQ") == 0) {
+            events |= QSO_EVENT(QsoEventCq);
+        } else if(strcmp(token, qso->call) == 0) {
+            events |= QSO_EVENT(QsoEventCall);
+        } else if(strcmp(token, "73") == 0 || strcmp(token, "SK") == 0 || strcmp(token, ">") == 0 ||
+                  strcmp(token, "GB") == 0) {
+            events |= QSO_EVENT(QsoEventClose);
+        } else if(name_next && strlen(token) <= QSO_NAME_MAX && strpbrk(token, "?*") == NULL) {
+            strcpy(qso->op_name, token);
+        }
+        name_next = strcmp(token, "NAME") == 0 || strcmp(token, "OP") == 0;
+    }
+
+    // Callsign and report are found the same way as for the contact log
+    AdifQso heard;
+    memset(&heard, 0, sizeof(heard));
+    adif_prefill(&heard, qso->over);
+    if(heard.call[0] != '\0' && strcmp(heard.call, qso->call) != 0) strcpy(qso->op_call, heard.call);
+    if(heard.rst_rcvd[0] != '\0') events |= QSO_EVENT(QsoEventReport);
+
+    return events ? events : QSO_EVENT(QsoEventOther);
+}
+
+// Fill a reply template; unknown operator fields fall back to a generic word
+static void qso_expand(const QsoBot* qso, const char* template, char* out, size_t size) {
+    size_t length = 0;
+    for(const char* c = template; *c && length + 1 < size; c++) {
+        const char* field = NULL;
+        if(c[0] == '$' && c[1] != '\0') {
+            switch(c[1]) {
+                case 'C': field = qso->call; break;
+                case 'N': field = qso->name; break;
+                case 'R': field = qso->report; break;
+                case 'O': field = qso->op_call[0] ? qso->op_call : "QRZ"; break;
+                case 'P': field = qso->op_name[0] ? qso->op_name : "OM"; break;
+                default: break;
+            }
+        }
+        if(!field) {
+            out[length++] = *c;
+            continue;
+        }
+        for(; *field && length + 1 < size; field++) out[length++] = *field;
+        c++;
+    }
+    out[length] = '\0';
+}
+
+// Hand the reply to the sound worker through the send ring, which fits it whole
+static void qso_key_reply(MorseApp* app) {
+    QsoBot* qso = &app->qso;
+    SendKeyer* send = &app->send;
+    send->head = 0;
+    send->tail = 0;
+    send->wpm = qso->wpm;
+    send->drain = true;
+    for(const char* c = qso->reply; *c; c++) send_type(send, *c);
+    send_type(send, ' ');
+
+    app->sound_abort = false;
+    app->sound_busy = true;
+    SoundCommand cmd = SoundCommandSend;
+    if(furi_message_queue_put(app->sound_queue, &cmd, 0) != FuriStatusOk) {
+        app->sound_busy = false;
+    }
+}
+
+// The over is complete: look up the rule for what it contained and answer
+static void qso_answer(MorseApp* app) {
+    QsoBot* qso = &app->qso;
+    uint8_t events = qso_classify(qso);
+    FURI_LOG_I("MorseMaster", "QSO over \"%s\"", qso->over);
+    qso->over_length = 0;
+    qso->over[0] = '\0';
+    marquee_push(qso->heard, QSO_HEARD_SHOWN, ' ');
+
+    for(size_t i = 0; i < COUNT_OF(QSO_RULES); i++) {
+        const QsoRule* rule = &QSO_RULES[i];
+        if((rule->state != QsoBotAny && rule->state != qso->state) || !(rule->events & events)) continue;
+
+        int wpm = qso->wpm + rule->wpm_step;
+        qso->wpm = (wpm < MIN_WPM) ? MIN_WPM : (wpm > MAX_WPM ? MAX_WPM : wpm);
+        if(rule->reply) qso_expand(qso, rule->reply, qso->reply, sizeof(qso->reply));
+        if(rule->next != QsoBotStay) qso->state = rule->next;
+        if(qso->reply[0] != '\0') qso_key_reply(app);
+        return;
+    }
+}
+
+// Silence after the last release at which qso_tick acts next: the word gap
+// while a character is open, then the end of the over plus the set delay.
+// 0 while there is nothing to wait for.
+static uint32_t qso_deadline_us(const MorseApp* app) {
+    const QsoBot* qso = &app->qso;
+    if(qso->key_down || !qso->keyed || app->sound_busy) return 0;
+    uint32_t dot_us = qso->decoder.dot_us;
+    uint32_t word_us = 5 * dot_us;
+    if((qso->filter.pending || qso->decoder.code_length > 0) &&
+       morse_clock_us() - qso->edge_us < word_us) {
+        return word_us;
+    }
+    return QSO_OVER_GAP_DOTS * dot_us + qso->delay_ms * 1000u;
+}
+
+// How long the main loop may wait for input before qso_tick is due, at most
+// limit_ms, so the reply starts on time rather than on the next poll
+static uint32_t qso_wait_ms(const MorseApp* app, uint32_t limit_ms) {
+    uint32_t deadline_us = qso_deadline_us(app);
+    if(deadline_us == 0) return limit_ms;
+    uint32_t silent_us = morse_clock_us() - app->qso.edge_us;
+    if(silent_us >= deadline_us) return 0;
+    uint32_t wait_ms = (deadline_us - silent_us + 999) / 1000;
+    return wait_ms < limit_ms ? wait_ms : limit_ms;
+}
+
+// Main loop side. Word gaps are closed here so the text shows while the key is
+// up; the over ends after QSO_OVER_GAP_DOTS of the operator's own dots, and the
+// reply follows after the set delay. The main loop's input wait ends at the
+// next of these deadlines (qso_wait_ms), so nothing is left to the poll.
+static void qso_tick(MorseApp* app) {
+    QsoBot* qso = &app->qso;
+    if(qso->key_down || !qso->keyed || app->sound_busy) return;
+
+    uint32_t silent_us = morse_clock_us() - qso->edge_us;
+    uint32_t dot_us = qso->decoder.dot_us;
+    if((qso->filter.pending || qso->decoder.code_length > 0) && silent_us >= 5 * dot_us) {
+        morse_filter_run(&qso->filter, false, silent_us);
+        morse_filter_flush(&qso->filter);
+        morse_view_update(app);
+    }
+    if(silent_us >= QSO_OVER_GAP_DOTS * dot_us + qso->delay_ms * 1000u) {
+        qso->keyed = false;
+        qso_answer(app);
+        morse_view_update(app);
+    }
+}
+
+// What BACK does on the way out of a mode, for commands that go straight to another
+static void leave_state(MorseApp* app) {
+    switch(app->app_state) {
+        case MorseStateFox:
+            fox_stop(app);
+            break;
+        case MorseStateListen:
+            listen_stop(app);
+            break;
+        case MorseStateLog:
+            adif_writer_flush(&app->log.writer);
+            break;
+        case MorseStateBenchmark:
+            bench_stop(app);
+            break;
+        default:
+            break;
+    }
+
+    // Whatever the sound worker is keying stops after the element on the air
+    if(app->sound_busy) {
+        app->sound_abort = true;
+        for(int i = 0; i < 100 && app->sound_busy; i++) furi_delay_ms(10);
+    }
+}
+
+// Build the command trie once; commands sharing a prefix share its nodes
+static void command_init(MorseApp* app) {
+    MorseCommander* commander = &app->commander;
+    memset(commander, 0, sizeof(MorseCommander));
+    commander->node_count = 1;
+    commander->nodes[0].command = -1;
+    commander->node = -1;
+    commander->pending = -1;
+
+    for(size_t i = 0; i < COUNT_OF(MORSE_COMMANDS); i++) {
+        uint8_t node = 0;
+        for(const char* c = MORSE_COMMANDS[i].text; *c; c++) {
+            uint8_t child = commander->nodes[node].child;
+            while(child && commander->nodes[child].character != *c) child = commander->nodes[child].sibling;
+            if(!child) {
+                furi_check(commander->node_count < COMMAND_NODES_MAX);
+                child = commander->node_count++;
+                commander->nodes[child] = (CommandNode){*c, 0, commander->nodes[node].child, -1};
+                commander->nodes[node].child = child;
+            }
+            node = child;
+        }
+        commander->nodes[node].command = (int8_t)i;
+    }
+    morse_decoder_init(&commander->decoder, COMMAND_KEY_WPM, NULL, NULL);
+}
+
+// One decoded character, one step down the trie. A finished command is left
+// for the main loop, which is free to leave the mode that decoded it.
+static void command_feed(MorseApp* app, char character) {
+    MorseCommander* commander = &app->commander;
+    if(!commander->enabled || character == ' ') return;
+
+    uint32_t now = furi_get_tick();
+    if(now - commander->char_tick > COMMAND_TIMEOUT_MS) commander->node = -1;
+    commander->char_tick = now;
+
+    if(character == COMMAND_PREFIX) {
+        commander->node = 0;
+        commander->value = 0;
+        commander->heard[0] = COMMAND_PREFIX;
+        commander->heard[1] = '\0';
+        return;
+    }
+    if(commander->node < 0) return;
+
+    bool digit = character >= '0' && character <= '9';
+    uint8_t child = commander->nodes[commander->node].child;
+    while(child && commander->nodes[child].character != character &&
+          !(digit && commander->nodes[child].character == '#')) {
+        child = commander->nodes[child].sibling;
+    }
+    if(!child) {
+        // Not a command: drop it and say so
+        commander->node = -1;
+        commander->heard[0] = '\0';
+        play_cue(app, false);
+        return;
+    }
+
+    if(commander->nodes[child].character == '#') commander->value = commander->value * 10 + (character - '0');
+    size_t length = strlen(commander->heard);
+    if(length < COMMAND_HEARD_MAX) {
+        commander->heard[length] = character;
+        commander->heard[length + 1] = '\0';
+    }
+    if(commander->nodes[child].command >= 0) {
+        commander->pending = commander->nodes[child].command;
+        commander->pending_value = commander->value;
+        commander->node = -1;
+    } else {
+        commander->node = child;
+    }
+}
+
+// Menu straight key: the same edges-to-decoder path as the QSO Bot. Runs on
+// the main loop like command_tick, which flushes the same filter.
+static void command_edge(MorseApp* app, bool down) {
+    MorseCommander* commander = &app->commander;
+    if(down == commander->key_down) return;
+
+    uint32_t now = app->input_time_us;
+    uint32_t elapsed_us = now - commander->edge_us;
+    if(!down) {
+        morse_filter_run(&commander->filter, true, elapsed_us);
+        commander->keyed = true;
+    } else if(commander->keyed) {
+        morse_filter_run(&commander->filter, false, elapsed_us);
+    }
+    commander->key_down = down;
+    commander->edge_us = now;
+}
+
+static void command_decoded_callback(char character, void* context) {
+    command_feed(context, character);
+}
+
+static void command_start_key(MorseApp* app) {
+    MorseCommander* commander = &app->commander;
+    uint32_t dot_us = commander->decoder.dot_us;
+    morse_decoder_init(&commander->decoder, COMMAND_KEY_WPM, command_decoded_callback, app);
+    commander->decoder.dot_us = dot_us;  // Keep the operator's speed between visits
+    morse_filter_init(&commander->filter, &commander->decoder, app->filter_percent);
+    commander->key_down = false;
+    commander->keyed = false;
+}
+
+// Ends menu characters after a gap and runs a finished command
+static void command_tick(MorseApp* app) {
+    MorseCommander* commander = &app->commander;
+    if(!commander->enabled) return;
+
+    if(app->app_state == MorseStateMenu && commander->keyed && !commander->key_down) {
+        uint32_t silent_us = morse_clock_us() - commander->edge_us;
+        if(silent_us >= COMMAND_GAP_DOTS * commander->decoder.dot_us) {
+            morse_filter_run(&commander->filter, false, silent_us);
+            morse_filter_flush(&commander->filter);
+            commander->keyed = false;
+            morse_view_update(app);
+        }
+    }
+    if(commander->node >= 0 && furi_get_tick() - commander->char_tick > COMMAND_TIMEOUT_MS) {
+        // Unfinished command dropped
+        commander->node = -1;
+        commander->heard[0] = '\0';
+        morse_view_update(app);
+    }
+    if(commander->pending < 0) return;
+
+    const MorseCommand* command = &MORSE_COMMANDS[commander->pending];
+    uint16_t value = commander->pending_value;
+    commander->pending = -1;
+    commander->heard[0] = '\0';
+    FURI_LOG_I("MorseMaster", "Command %s %u", command->text, value);
+
+    bool ok = true;
+    switch(command->action) {
+        case CommandMode:
+            leave_state(app);
+            enter_state(app, command->state);
+            break;
+        case CommandSpeed:
+            ok = value >= MIN_WPM && value <= MAX_WPM;
+            if(ok) {
+                app->send.wpm = (uint8_t)value;
+                if(app->app_state == MorseStateQso) app->qso.wpm = (uint8_t)value;
+            }
+            break;
+        case CommandVolume:
+            app->volume = value / 9.0f;
+            break;
+        case CommandOff:
+            commander->enabled = false;
+            break;
+    }
+    play_cue(app, ok);
+    morse_view_update(app);
+}
+
+static uint32_t bench_cycles(void) {
+    return furi_hal_cortex_timer_get(0).start;
+}
+
+static int bench_compare(const void* a, const void* b) {
+    uint32_t left = *(const uint32_t*)a;
+    uint32_t right = *(const uint32_t*)b;
+    return (left > right) - (left < right);
+}
+
+// Sort the samples and publish min/avg/p99 as the next result row
+static void bench_add(MorseApp* app, const char* name, uint32_t* samples, uint16_t count) {
+    BenchSuite* bench = &app->bench;
+    if(count == 0 || bench->result_count >= BENCH_RESULTS) return;
+
+    qsort(samples, count, sizeof(uint32_t), bench_compare);
+    uint64_t total = 0;
+    for(uint16_t i = 0; i < count; i++) total += samples[i];
+
+    BenchResult* result = &bench->results[bench->result_count];
+    result->name = name;
+    result->min = samples[0];
+    result->avg = (uint32_t)(total / count);
+    result->p99 = samples[(count * 99u) / 100u];
+    result->count = count;
+    bench->result_count++;
+    morse_view_update(app);
+}
+
+// Append this run to the report; the header says which app, firmware and format
+static void bench_save(MorseApp* app) {
+    BenchSuite* bench = &app->bench;
+    DateTime now;
+    furi_hal_rtc_get_datetime(&now);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, MORSE_DATA_DIR);
+    File* file = storage_file_alloc(storage);
+    bool ok = storage_file_open(file, BENCH_REPORT_PATH, FSAM_WRITE, FSOM_OPEN_APPEND);
+
+    char line[96];
+    int length = snprintf(
+        line, sizeof(line), "[run]\nformat: %d\napp: %s\nfirmware: %s %s\n", BENCH_REPORT_FORMAT,
+        MORSE_APP_VERSION, version_get_version(NULL), version_get_githash(NULL));
+    ok = ok && storage_file_write(file, line, length) == (size_t)length;
+    length = snprintf(
+        line, sizeof(line), "date: %04d-%02d-%02d %02d:%02d:%02d\ncpu_mhz: %lu\nname,min,avg,p99,samples\n",
+        now.year, now.month, now.day, now.hour, now.minute, now.second,
+        (unsigned long)furi_hal_cortex_instructions_per_microsecond());
+    ok = ok && storage_file_write(file, line, length) == (size_t)length;
+
+    for(uint8_t i = 0; i < bench->result_count && ok; i++) {
+        const BenchResult* result = &bench->results[i];
+        length = snprintf(
+            line, sizeof(line), "%s,%lu,%lu,%lu,%u\n", result->name, (unsigned long)result->min,
+            (unsigned long)result->avg, (unsigned long)result->p99, result->count);
+        ok = storage_file_write(file, line, length) == (size_t)length;
+    }
+    ok = ok && storage_file_write(file, "\n", 1) == 1;
+    bench->saved = ok;
+    if(!ok) FURI_LOG_E("MorseMaster", "Failed to save %s", BENCH_REPORT_PATH);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+// Runner: every measurement uses the cycle counter, converted to ns or us
+static int32_t bench_worker_thread(void* context) {
+    MorseApp* app = context;
+    BenchSuite* bench = &app->bench;
+    uint32_t* samples = bench->samples;
+    uint32_t per_us = furi_hal_cortex_instructions_per_microsecond();
+    volatile char sink = 0;
+    uint16_t count;
+
+    // Table lookups, one character each way per lookup
+    for(count = 0; count < BENCH_LOOKUP_ROUNDS && !bench->stop; count++) {
+        uint32_t start = bench_cycles();
+        for(size_t i = 0; i < MORSE_TABLE_SIZE; i++) {
+            sink ^= get_char_for_morse(get_morse_for_char(MORSE_TABLE[i].character));
+        }
+        samples[count] = (bench_cycles() - start) * 1000u / per_us / (2 * MORSE_TABLE_SIZE);
+    }
+    UNUSED(sink);
+    bench_add(app, "Lookup ns", samples, count);
+
+    // Keying schedule generation for a short over
+    MorseSchedule schedule;
+    for(count = 0; count < BENCH_SCHEDULE_ROUNDS && !bench->stop; count++) {
+        uint32_t start = bench_cycles();
+        encode_schedule(&schedule, BENCH_SCHEDULE_TEXT, SEND_DEFAULT_WPM);
+        samples[count] = (bench_cycles() - start) / per_us;
+    }
+    bench_add(app, "Schedule us", samples, count);
+
+    // Sound queue: enqueue to the worker picking the command up, from idle
+    for(count = 0; count < BENCH_QUEUE_ROUNDS && !bench->stop; count++) {
+        furi_delay_ms(BENCH_QUEUE_IDLE_MS);
+        bench->started = false;
+        SoundCommand cmd = SoundCommandBench;
+        uint32_t start = morse_clock_us();
+        if(furi_message_queue_put(app->sound_queue, &cmd, 0) != FuriStatusOk) break;
+        while(!bench->started && !bench->stop) furi_delay_ms(1);
+        samples[count] = bench->started_us - start;
+    }
+    bench_add(app, "Queue us", samples, count);
+
+    // Element timing: dots keyed silently through play_schedule, each start
+    // against its ideal time from the first
+    uint32_t edges[SCHEDULE_MAX_ELEMENTS];
+    schedule.count = SCHEDULE_MAX_ELEMENTS;
+    for(uint16_t i = 0; i < schedule.count; i++) schedule.elements[i] = (i % 2) ? -1 : 1;
+    schedule_units_to_ms(&schedule, BENCH_JITTER_WPM);
+    float volume = app->volume;
+    count = 0;
+    for(uint8_t run = 0; run < BENCH_JITTER_RUNS && !bench->stop; run++) {
+        app->volume = 0.0f;
+        bench->edges = edges;
+        play_schedule_async(app, &schedule);
+        while(app->sound_busy) furi_delay_ms(10);
+        bench->edges = NULL;
+        app->volume = volume;
+
+        uint32_t ideal_ms = 0;
+        for(uint16_t i = 0; i < schedule.count && count < BENCH_SAMPLES; i++) {
+            int32_t late = (int32_t)(edges[i] - edges[0] - ideal_ms * 1000u);
+            samples[count++] = (uint32_t)(late < 0 ? -late : late);
+            int16_t element = schedule.elements[i];
+            ideal_ms += (element > 0) ? element : -element;
+        }
+    }
+    bench_add(app, "Jitter us", samples, count);
+
+    // Draw callback per screen, rendered through the real view port
+    for(size_t screen = 0; screen < COUNT_OF(BENCH_SCREENS) && !bench->stop; screen++) {
+        for(count = 0; count < BENCH_DRAW_ROUNDS && !bench->stop; count++) {
+            bench->draw_done = false;
+            bench->draw_screen = BENCH_SCREENS[screen].state;
+            bench->draw_probe = true;
+            morse_view_update(app);
+            for(uint32_t waited = 0; !bench->draw_done && waited < BENCH_DRAW_TIMEOUT_MS; waited++) furi_delay_ms(1);
+            if(!bench->draw_done) break;
+            samples[count] = bench->draw_cycles / per_us;
+        }
+        bench->draw_probe = false;
+        bench_add(app, BENCH_SCREENS[screen].name, samples, count);
+    }
+    bench->draw_probe = false;
+
+    if(!bench->stop) bench_save(app);
+    bench->running = false;
+    morse_view_update(app);
+    return 0;
+}
+
+static void bench_stop(MorseApp* app) {
+    BenchSuite* bench = &app->bench;
+    if(!bench->thread) return;
+
+    bench->stop = true;
+    app->sound_abort = true;
+    furi_thread_join(bench->thread);
+    furi_thread_free(bench->thread);
+    bench->thread = NULL;
+    bench->running = false;
+}
+
+static void bench_start(MorseApp* app) {
+    BenchSuite* bench = &app->bench;
+    bench_stop(app);
+    if(app->sound_busy) return;
+
+    bench->result_count = 0;
+    bench->scroll = 0;
+    bench->saved = false;
+    bench->stop = false;
+    bench->running = true;
+    bench->thread = furi_thread_alloc_ex("MorseBench", 2048, bench_worker_thread, app);
+    furi_thread_start(bench->thread);
+}
+
+// Draw application UI based on current state
+static void morse_app_draw_callback(Canvas* canvas, void* ctx) {
+    MorseApp* app = ctx;
+    if(!app || !canvas) return;
+
+    // Screen off: the one frame drawn on the way there stays blank
+    if(app->screen_off) {
+        canvas_clear(canvas);
+        return;
+    }
+
+    // The benchmark borrows the display to time other screens
+    bool probe = app->bench.draw_probe;
+    MorseAppState screen = probe ? app->bench.draw_screen : app->app_state;
+    uint32_t draw_start = furi_hal_cortex_timer_get(0).start;
+
+    canvas_clear(canvas);
+    // Make background black
+    canvas_set_color(canvas, ColorBlack);
+    canvas_draw_box(canvas, 0, 0, 128, 64);
+    canvas_draw_icon(canvas, 0, 45, &I_menu_bg);
+
+    switch(screen) {
+        case MorseStateTitleScreen:
+            canvas_draw_icon(canvas, 0, 0, &I_title_screen);
+            break;
+
+        case MorseStateMenu: {
+            canvas_draw_icon(canvas, 0, 45, &I_menu_bg);
+            canvas_draw_icon(canvas, 4, 5, &I_wood);
+
+            // Display title based on current selection at the top
+            canvas_set_font(canvas, FontPrimary);
+            canvas_set_color(canvas, ColorBlack);
+            const MorseCommander* commander = &app->commander;
+            if(commander->enabled && commander->heard[0] != '\0') {
+                // The command being keyed takes the title's place
+                canvas_draw_str_aligned(canvas, 64, 12, AlignCenter, AlignCenter, commander->heard);
+            } else {
+                canvas_draw_str_aligned(canvas, 64, 12, AlignCenter, AlignCenter, MENU_ITEMS[app->menu_selection].title);
+            }
+            if(commander->enabled) {
+                // Morse control marker, filled while the key is down
+                if(commander->key_down) {
+                    canvas_draw_box(canvas, 116, 9, 5, 5);
+                } else {
+                    canvas_draw_frame(canvas, 116, 9, 5, 5);
+                }
+            }
+
+            // Menu shows one page of three icons at a time
+            const int16_t icon_x[MENU_PAGE_SIZE] = {12, 54, 94};
+            const int16_t y_offset = 24;
+            int page_start = app->menu_selection - app->menu_selection % MENU_PAGE_SIZE;
+            int column = app->menu_selection % MENU_PAGE_SIZE;
+            int item_count = menu_item_count(app);
+            for(int i = 0; i < MENU_PAGE_SIZE && page_start + i < item_count; i++) {
+                canvas_draw_icon(canvas, icon_x[i], y_offset + (i == column ? 8 : 0), MENU_ITEMS[page_start + i].icon);
+            }
+
+            // Arrows hint at the neighbouring pages
+            canvas_set_color(canvas, ColorWhite);
+            if(page_start > 0) canvas_draw_icon(canvas, 1, 30, &I_left);
+            if(page_start + MENU_PAGE_SIZE < item_count) canvas_draw_icon(canvas, 123, 30, &I_right);
+
+            const int16_t hand_y_offset = 46;
+            canvas_draw_icon(canvas, -15+column*40, hand_y_offset, &I_hand_left);
+            canvas_draw_icon(canvas, +35+column*40, hand_y_offset, &I_hand_right);
+
+            break;
+        }
+
+        case MorseStateLearn: {
+            canvas_draw_icon(canvas, 20, 22, &I_learning_bg);
+
+            canvas_draw_icon(canvas, 10, 36, &I_left);
+            canvas_draw_icon(canvas, 110, 36, &I_right);
+
+            canvas_draw_icon(canvas, 50, 10, &I_up);
+            canvas_draw_icon(canvas, 70, 10, &I_down);
+
+
+            canvas_set_font(canvas, FontPrimary);
+
+            // Display current character, centred where a single one sat
+            char txt[32];
+            char_label(app, app->current_char, true, txt, sizeof(txt));
+            canvas_draw_str_aligned(canvas, 44, 40, AlignCenter, AlignBottom, txt);
+
+            // Display Morse code as a cached glyph centered in the right panel
+            int index = get_table_index_for_char(app->current_char);
+            if(index >= 0) {
+                const MorseGlyph* glyph = &app->glyph_cache[index];
+                draw_glyph(
+                    canvas,
+                    62 + (GLYPH_LEARN_WIDTH - glyph->width) / 2,
+                    26 + (21 - glyph->height) / 2,
+                    glyph);
+            }
+
+            // A dot beside characters in the user's own set
+            if(index >= 0 && (app->learn_custom & MORSE_CHARSET_BIT(index))) canvas_draw_box(canvas, 53, 31, 3, 3);
+
+            // The sets UP and DOWN switch to
+            canvas_set_color(canvas, ColorWhite);
+            canvas_draw_str(canvas, 28, 16, LEARN_SETS[learn_set_step(app, -1)].label);
+            canvas_draw_str(canvas, 80, 16, LEARN_SETS[learn_set_step(app, 1)].label);
+            break;
+        }
+
+        case MorseStatePractice: {
+
+            canvas_draw_icon(canvas, 5, 15, &I_ball);
+            canvas_draw_icon(canvas, 0, 56, &I_desk);
+
+            // Show the appropriate beep icon and hand position based on input state
+            if(app->input_active) {
+                // When inputting: show beep_on and move hand down by 6px
+                canvas_draw_icon(canvas, 47, 34, &I_beep_on);
+                canvas_draw_icon(canvas, 80, 19, &I_hand); // Hand moved down by 6px
+            } else {
+                // Normal state: show beep_off and hand in normal position
+                canvas_draw_icon(canvas, 47, 34, &I_beep_off);
+                canvas_draw_icon(canvas, 80, 13, &I_hand); // Normal position
+            }
+
+            canvas_draw_icon(canvas, 114, 52, &I_vol_bg);
+            canvas_set_color(canvas, ColorWhite);
+            // Display volume icon based on volume level
+            if(app->volume == 0.0f) {
+                canvas_draw_icon(canvas, 117, 55, &I_vol_0);
+            } else if(app->volume <= 0.25f) {
+                canvas_draw_icon(canvas, 117, 55, &I_vol_25);
+            } else if(app->volume <= 0.50f) {
+                canvas_draw_icon(canvas, 117, 55, &I_vol_50);
+            } else if(app->volume <= 0.75f) {
+                canvas_draw_icon(canvas, 117, 55, &I_vol_75);
+            } else {
+                canvas_draw_icon(canvas, 117, 55, &I_vol_100);
+            }
+
+            canvas_set_font(canvas, FontPrimary);
+
+            canvas_draw_str(canvas, 5, 12, app->top_words);
+
+            // Re-render the input glyph only when the keyed code changed
+            if(strcmp(app->input_glyph_code, app->current_morse) != 0) {
+                strncpy(app->input_glyph_code, app->current_morse, MAX_MORSE_LENGTH - 1);
+                app->input_glyph_code[MAX_MORSE_LENGTH - 1] = '\0';
+                render_glyph(&app->input_glyph, app->current_morse, GLYPH_PRACTICE_WIDTH);
+            }
+            draw_glyph(canvas, 8 + (GLYPH_PRACTICE_WIDTH - app->input_glyph.width) / 2, 29, &app->input_glyph);
+
+
+
+            break;
+        }
+
+        case MorseStateFox: {
+            canvas_set_color(canvas, ColorBlack);
+            canvas_draw_icon(canvas, 5, 6, &I_board);
+            canvas_draw_icon(canvas, 104, 52, &I_branch);
+            canvas_set_font(canvas, FontSecondary);
+
+            FoxHunt* fox = &app->fox;
+            char line[32];
+            int16_t x_offset = 12;
+            int16_t y_offset = 18;
+
+            if(!fox->running) {
+                // Config rows, selected one is marked
+                const char* labels[FoxFieldCount] = {"Fox", "Foxes", "Speed", "GPIO key"};
+                for(int i = 0; i < FoxFieldCount; i++) {
+                    switch(i) {
+                        case FoxFieldNumber:
+                            snprintf(line, sizeof(line), "%s: %d (%s)", labels[i], fox->number, FOX_IDS[fox->number - 1]);
+                            break;
+                        case FoxFieldFoxes:
+                            snprintf(line, sizeof(line), "%s: %d", labels[i], fox->foxes);
+                            break;
+                        case FoxFieldSpeed:
+                            snprintf(line, sizeof(line), "%s: %d WPM", labels[i], fox->wpm);
+                            break;
+                        default:
+                            snprintf(line, sizeof(line), "%s: %s", labels[i], fox->gpio ? "On" : "Off");
+                            break;
+                    }
+                    canvas_draw_str(canvas, x_offset + 6, y_offset, line);
+                    if(i == (int)fox->field) canvas_draw_str(canvas, x_offset, y_offset, ">");
+                    y_offset += 9;
+                }
+                canvas_draw_str(canvas, x_offset, y_offset + 3, "OK: start");
+            } else {
+                DateTime now;
+                furi_hal_rtc_get_datetime(&now);
+
+                snprintf(line, sizeof(line), "Fox %d of %d: %s", fox->number, fox->foxes, FOX_IDS[fox->number - 1]);
+                canvas_draw_str(canvas, x_offset, y_offset, line);
+                y_offset += 12;
+
+                canvas_set_font(canvas, FontPrimary);
+                if(fox->on_air) {
+                    canvas_draw_str(canvas, x_offset, y_offset + 2, "ON AIR");
+                } else {
+                    uint32_t seconds = fox_seconds_to_slot(fox, &now);
+                    snprintf(line, sizeof(line), "Next in %lu:%02lu", (unsigned long)(seconds / 60), (unsigned long)(seconds % 60));
+                    canvas_draw_str(canvas, x_offset, y_offset + 2, line);
+                }
+                y_offset += 14;
+
+                canvas_set_font(canvas, FontSecondary);
+                snprintf(line, sizeof(line), "RTC %02d:%02d:%02d", now.hour, now.minute, now.second);
+                canvas_draw_str(canvas, x_offset, y_offset, line);
+                y_offset += 12;
+                canvas_draw_str(canvas, x_offset, y_offset, "OK: stop");
+            }
+            break;
+        }
+
+        case MorseStateLadder: {
+            canvas_set_color(canvas, ColorBlack);
+            canvas_draw_icon(canvas, 5, 6, &I_board);
+            canvas_draw_icon(canvas, 104, 52, &I_branch);
+            canvas_set_font(canvas, FontSecondary);
+
+            LadderTest* ladder = &app->ladder;
+            char line[32];
+            int16_t x_offset = 12;
+            int16_t y_offset = 18;
+
+            switch(ladder->phase) {
+                case LadderPhaseSetup: {
+                    const char* labels[LadderFieldCount] = {"Start", "Step", "Misses"};
+                    const uint8_t values[LadderFieldCount] = {ladder->base_wpm, ladder->step_wpm, ladder->max_misses};
+                    for(int i = 0; i < LadderFieldCount; i++) {
+                        snprintf(line, sizeof(line), "%s: %d%s", labels[i], values[i], i == LadderFieldMisses ? "" : " WPM");
+                        canvas_draw_str(canvas, x_offset + 6, y_offset, line);
+                        if(i == (int)ladder->field) canvas_draw_str(canvas, x_offset, y_offset, ">");
+                        y_offset += 9;
+                    }
+
+                    // Most recent results, newest first
+                    int length = snprintf(line, sizeof(line), "Last:");
+                    for(int i = 0; i < ladder->history_count && length < (int)sizeof(line); i++) {
+                        length += snprintf(line + length, sizeof(line) - length, " %d", ladder->history[ladder->history_count - 1 - i].max_wpm);
+                    }
+                    canvas_draw_str(canvas, x_offset, y_offset + 1, ladder->history_count ? line : "Last: -");
+                    canvas_draw_str(canvas, x_offset, y_offset + 10, "OK: start");
+                    break;
+                }
+
+                case LadderPhasePlaying:
+                case LadderPhaseGrading:
+                    snprintf(
+                        line,
+                        sizeof(line),
+                        "%d WPM ok %d/%d miss %d/%d",
+                        ladder->wpm,
+                        ladder->copied,
+                        LADDER_COPIES_TO_PASS,
+                        ladder->misses,
+                        ladder->max_misses);
+                    canvas_draw_str(canvas, x_offset, y_offset, line);
+
+                    canvas_set_font(canvas, FontPrimary);
+                    if(ladder->phase == LadderPhasePlaying) {
+                        canvas_draw_str(canvas, x_offset, y_offset + 16, "Listen...");
+                    } else {
+                        canvas_draw_str(canvas, x_offset, y_offset + 16, ladder->groups[ladder->group]);
+                        canvas_set_font(canvas, FontSecondary);
+                        canvas_draw_str(canvas, x_offset, y_offset + 30, "Copied it?");
+                        canvas_draw_str(canvas, x_offset, y_offset + 39, "<: missed  >: copied");
+                    }
+                    break;
+
+                case LadderPhaseDone:
+                    canvas_draw_str(canvas, x_offset, y_offset, "Max copy speed");
+                    canvas_set_font(canvas, FontPrimary);
+                    if(ladder->best_wpm > 0) {
+                        snprintf(line, sizeof(line), "%d WPM", ladder->best_wpm);
+                    } else {
+                        snprintf(line, sizeof(line), "below %d WPM", ladder->base_wpm);
+                    }
+                    canvas_draw_str(canvas, x_offset, y_offset + 16, line);
+                    canvas_set_font(canvas, FontSecondary);
+                    snprintf(line, sizeof(line), "Seed %08lX", (unsigned long)app->session_seed);
+                    canvas_draw_str(canvas, x_offset, y_offset + 30, line);
+                    canvas_draw_str(canvas, x_offset, y_offset + 39, "OK: again");
+                    break;
+            }
+            break;
+        }
+
+        case MorseStateStream: {
+            canvas_set_color(canvas, ColorBlack);
+            canvas_draw_icon(canvas, 5, 6, &I_board);
+            canvas_draw_icon(canvas, 104, 52, &I_branch);
+            canvas_set_font(canvas, FontSecondary);
+
+            MorseStream* stream = &app->stream;
+            char line[32];
+            int16_t x_offset = 12;
+
+            // File name without the directory
+            const char* name = strrchr(stream->path, '/');
+            name = name ? name + 1 : stream->path;
+            snprintf(line, sizeof(line), "%s", name);
+            canvas_draw_str(canvas, x_offset, 18, line);
+
+            canvas_set_font(canvas, FontPrimary);
+            canvas_draw_str(canvas, x_offset, 33, stream->text);
+            canvas_set_font(canvas, FontSecondary);
+
+            if(stream->failed) {
+                snprintf(line, sizeof(line), "Cannot open file");
+            } else {
+                snprintf(line, sizeof(line), "%s %lu chars",
+                    stream->done ? "Done," : (stream->kind == StreamKindText ? "Keying," : "Decoding,"),
+                    (unsigned long)stream->characters);
+            }
+            canvas_draw_str(canvas, x_offset, 45, line);
+
+            if(stream->first_element_us >= 0) {
+                snprintf(
+                    line,
+                    sizeof(line),
+                    "First element %ld.%ld ms",
+                    (long)(stream->first_element_us / 1000),
+                    (long)(stream->first_element_us % 1000 / 100));
+                canvas_draw_str(canvas, x_offset, 54, line);
+            }
+            break;
+        }
+
+        case MorseStateListen: {
+            canvas_set_color(canvas, ColorBlack);
+            canvas_draw_icon(canvas, 5, 6, &I_board);
+            canvas_draw_icon(canvas, 104, 52, &I_branch);
+            canvas_set_font(canvas, FontSecondary);
+
+            MorseListener* listen = &app->listen;
+            const MorseToneDetector* tone = &listen->tone;
+            char line[32];
+            int16_t x_offset = 12;
+
+            if(listen->timer_busy) {
+                canvas_draw_str(canvas, x_offset, 18, "Sample timer in use");
+                break;
+            }
+
+            if(tone->pitch_hz > 0) {
+                snprintf(line, sizeof(line), "Pitch: %d Hz", (int)(tone->pitch_hz + 0.5f));
+            } else {
+                snprintf(line, sizeof(line), "Searching %d-%d Hz", PITCH_MIN_HZ, PITCH_MAX_HZ);
+            }
+            canvas_draw_str(canvas, x_offset, 18, line);
+
+            canvas_set_font(canvas, FontPrimary);
+            canvas_draw_str(canvas, x_offset, 31, listen->text);
+            canvas_set_font(canvas, FontSecondary);
+
+            // Tone level against the held peak, with the key state beside it
+            int16_t level_px = 0;
+            if(tone->peak > 0) level_px = (int16_t)(LISTEN_LEVEL_BAR_PX * tone->level / tone->peak);
+            if(level_px > LISTEN_LEVEL_BAR_PX) level_px = LISTEN_LEVEL_BAR_PX;
+            canvas_draw_frame(canvas, x_offset, 35, LISTEN_LEVEL_BAR_PX + 2, 5);
+            canvas_draw_box(canvas, x_offset + 1, 36, level_px, 3);
+            if(listen->key) canvas_draw_box(canvas, x_offset + LISTEN_LEVEL_BAR_PX + 6, 35, 5, 5);
+
+            // A known word takes the two status lines for a while
+            const MorseGloss* gloss = listen->gloss;
+            if(listen->glossary && gloss && furi_get_tick() - listen->gloss_tick < LISTEN_GLOSS_MS) {
+                snprintf(line, sizeof(line), "%s:", gloss->word);
+                canvas_draw_str(canvas, x_offset, 49, line);
+                canvas_draw_str(canvas, x_offset, 57, gloss->meaning);
+                break;
+            }
+
+            snprintf(line, sizeof(line), "%lu WPM  DSP %d%%",
+                (unsigned long)(1200000 / listen->decoder.dot_us), listen->dsp_load);
+            canvas_draw_str(canvas, x_offset, 49, line);
+            if(listen->filter.percent) {
+                snprintf(line, sizeof(line), "Filter %d%%: %lu", listen->filter.percent,
+                    (unsigned long)listen->filter.suppressed);
+            } else {
+                snprintf(line, sizeof(line), "Filter off");
+            }
+            canvas_draw_str(canvas, x_offset, 57, line);
+            break;
+        }
+
+        case MorseStateProgress: {
+            canvas_set_color(canvas, ColorBlack);
+            canvas_draw_icon(canvas, 5, 6, &I_board);
+            canvas_draw_icon(canvas, 104, 52, &I_branch);
+            canvas_set_font(canvas, FontSecondary);
+
+            const ProgressGraph* graph = &app->progress;
+            const char* names[ProgressMetricCount] = {"Chars", "Accuracy %", "Avg WPM", "Max WPM", "Minutes"};
+            const uint16_t* values = graph->values[graph->metric];
+            char line[32];
+
+            uint16_t max = 0;
+            for(uint8_t i = 0; i < graph->days; i++) {
+                if(values[i] > max) max = values[i];
+            }
+
+            snprintf(line, sizeof(line), "%s %dd", names[graph->metric], graph->days);
+            canvas_draw_str(canvas, 12, 17, line);
+            if(graph->empty) {
+                canvas_draw_str_aligned(canvas, 52, 38, AlignCenter, AlignCenter, "No training yet");
+                break;
+            }
+            snprintf(line, sizeof(line), "%u", max);
+            canvas_draw_str_aligned(canvas, 95, 17, AlignRight, AlignBottom, line);
+
+            // One bar per day, today on the right
+            uint8_t pitch = PROGRESS_GRAPH_WIDTH / graph->days;
+            uint8_t bar = (pitch > 1) ? pitch - 1 : 1;
+            for(uint8_t i = 0; i < graph->days; i++) {
+                if(values[i] == 0) continue;
+                int16_t height = (int16_t)(((uint32_t)values[i] * PROGRESS_GRAPH_HEIGHT + max - 1) / max);
+                canvas_draw_box(canvas, PROGRESS_GRAPH_X + i * pitch, PROGRESS_GRAPH_BOTTOM - height, bar, height);
+            }
+            canvas_draw_line(canvas, PROGRESS_GRAPH_X, PROGRESS_GRAPH_BOTTOM,
+                PROGRESS_GRAPH_X + PROGRESS_GRAPH_WIDTH - 1, PROGRESS_GRAPH_BOTTOM);
+            break;
+        }
+
+        case MorseStateEcho: {
+            canvas_set_color(canvas, ColorBlack);
+            canvas_draw_icon(canvas, 5, 6, &I_board);
+            canvas_draw_icon(canvas, 104, 52, &I_branch);
+            canvas_set_font(canvas, FontSecondary);
+
+            const EchoDrill* echo = &app->echo;
+            char line[32];
+            canvas_draw_str(canvas, 12, 17, ECHO_SOURCE_TITLES[echo->source]);
+            snprintf(line, sizeof(line), "%u/%u", echo->right, echo->total);
+            canvas_draw_str_aligned(canvas, 95, 17, AlignRight, AlignBottom, line);
+
+            draw_glyph(canvas, 12, 22, &echo->glyph);
+
+            if(echo->received) {
+                char target[8];
+                char received[8];
+                char_label(app, echo->target, true, target, sizeof(target));
+                char_label(app, echo->received, true, received, sizeof(received));
+                canvas_set_font(canvas, FontPrimary);
+                if(echo->received == echo->target) {
+                    snprintf(line, sizeof(line), "%s  right", target);
+                } else if(echo->received == MORSE_UNKNOWN) {
+                    snprintf(line, sizeof(line), "%s  not a code", target);
+                } else {
+                    // Edit distance between the two codes, from the prebuilt matrix
+                    uint8_t distance = app->similarity.distance[get_table_index_for_char(echo->target)]
+                                                               [get_table_index_for_char(echo->received)];
+                    snprintf(line, sizeof(line), "%s  not %s", target, received);
+                    canvas_draw_str(canvas, 12, 46, line);
+                    canvas_set_font(canvas, FontSecondary);
+                    snprintf(line, sizeof(line), "Codes %u element%s apart", distance, distance == 1 ? "" : "s");
+                    canvas_draw_str(canvas, 12, 55, line);
+                    break;
+                }
+                canvas_draw_str(canvas, 12, 50, line);
+            } else {
+                canvas_draw_str(canvas, 12, 44, "Key back what you hear");
+                canvas_draw_str(canvas, 12, 53, "LEFT: replay");
+            }
+            break;
+        }
+
+        case MorseStateReview: {
+            canvas_set_color(canvas, ColorBlack);
+            canvas_draw_icon(canvas, 5, 6, &I_board);
+            canvas_draw_icon(canvas, 104, 52, &I_branch);
+            canvas_set_font(canvas, FontSecondary);
+
+            const SelfReview* review = &app->review;
+            char line[32];
+            canvas_draw_str(canvas, 12, 17, "Review");
+            canvas_draw_str_aligned(
+                canvas, 95, 17, AlignRight, AlignBottom, app->keylog.spill ? "SD: on" : "SD: off");
+
+            if(review->own.count == 0) {
+                canvas_draw_str(canvas, 12, 33, "Nothing keyed yet.");
+                canvas_draw_str(canvas, 12, 42, "Hold BACK in Practice");
+                break;
+            }
+
+            canvas_draw_str(canvas, 12, 26, review->text);
+            snprintf(line, sizeof(line), "%u WPM, dash %u.%u dots", review->wpm, review->dash_x10 / 10, review->dash_x10 % 10);
+            canvas_draw_str(canvas, 12, 35, line);
+            snprintf(line, sizeof(line), "Element gap %u.%u dots", review->gap_x10 / 10, review->gap_x10 % 10);
+            canvas_draw_str(canvas, 12, 44, line);
+
+            if(review->active) {
+                canvas_draw_str(canvas, 12, 53, review->playing == ReviewPlayOwn ? "Playing yours..." : "Playing ideal...");
+            } else {
+                canvas_draw_str(canvas, 12, 53, "OK both <you ideal>");
+            }
+            break;
+        }
+
+        case MorseStateLog: {
+            canvas_set_color(canvas, ColorBlack);
+            canvas_draw_icon(canvas, 5, 6, &I_board);
+            canvas_draw_icon(canvas, 104, 52, &I_branch);
+            canvas_set_font(canvas, FontSecondary);
+
+            QsoLog* log = &app->log;
+            const char* labels[LogFieldCount] = {"Call", "Band", "Sent", "Rcvd", "Exch"};
+            char line[8];
+            int16_t x_offset = 12;
+            int16_t y_offset = 17;
+
+            snprintf(line, sizeof(line), "#%u", log->logged);
+            canvas_draw_str_aligned(canvas, 95, y_offset, AlignRight, AlignBottom, line);
+
+            for(LogField field = 0; field < LogFieldCount; field++) {
+                size_t max;
+                const char* value = qso_log_text(log, field, &max);
+                if(!value) value = ADIF_BANDS[log->band];
+
+                canvas_draw_str(canvas, x_offset + 6, y_offset, labels[field]);
+                canvas_draw_str(canvas, x_offset + 32, y_offset, value);
+                if(field == log->field) {
+                    canvas_draw_str(canvas, x_offset, y_offset, log->editing ? "*" : ">");
+                }
+
+                // Underline the character being edited
+                if(field == log->field && log->editing) {
+                    char prefix[ADIF_CALL_MAX + 1];
+                    strncpy(prefix, value, log->cursor);
+                    prefix[log->cursor] = '\0';
+                    int16_t x = x_offset + 32 + canvas_string_width(canvas, prefix);
+                    canvas_draw_line(canvas, x, y_offset + 1, x + 4, y_offset + 1);
+                }
+                y_offset += 9;
+            }
+            break;
+        }
+
+        case MorseStateSend: {
+            // Full-screen layout on a plain white background
             canvas_set_color(canvas, ColorWhite);
-            // Display volume icon based on volume level
-            if(app->volume == 0.0f) {
-                canvas_draw_icon(canvas, 117, 55, &I_vol_0);
-            } else if(app->volume <= 0.25f) {
-                canvas_draw_icon(canvas, 117, 55, &I_vol_25);
-            } else if(app->volume <= 0.50f) {
-                canvas_draw_icon(canvas, 117, 55, &I_vol_50);
-            } else if(app->volume <= 0.75f) {
-                canvas_draw_icon(canvas, 117, 55, &I_vol_75);
-            } else {
-                canvas_draw_icon(canvas, 117, 55, &I_vol_100);
+            canvas_draw_box(canvas, 0, 0, 128, 64);
+            canvas_set_color(canvas, ColorBlack);
+            canvas_set_font(canvas, FontSecondary);
+
+            SendKeyer* send = &app->send;
+            char line[SEND_UNSENT_SHOWN + 2];
+
+            // Keyed text, then the one on the air, then the unsent buffer in a frame
+            canvas_draw_str(canvas, 2, 9, send->sent);
+            snprintf(line, sizeof(line), "%u WPM", send->wpm);
+            if(send->row == 0) {
+                canvas_draw_box(canvas, 126 - canvas_string_width(canvas, line) - 2, 1, canvas_string_width(canvas, line) + 4, 10);
+                canvas_set_color(canvas, ColorWhite);
             }
+            canvas_draw_str_aligned(canvas, 126, 9, AlignRight, AlignBottom, line);
+            canvas_set_color(canvas, ColorBlack);
 
-            canvas_set_font(canvas, FontPrimary);
+            uint32_t depth = send_unsent(send, line, SEND_UNSENT_SHOWN);
+            canvas_draw_frame(canvas, 0, 12, 100, 12);
+            if(send->keying) {
+                char keying[2] = {send->keying == ' ' ? '_' : send->keying, '\0'};
+                canvas_draw_box(canvas, 1, 13, 8, 10);
+                canvas_set_color(canvas, ColorWhite);
+                canvas_draw_str(canvas, 3, 21, keying);
+                canvas_set_color(canvas, ColorBlack);
+            }
+            canvas_draw_str(canvas, 11, 21, line);
+            char counter[12];
+            snprintf(counter, sizeof(counter), "%lu/%d", (unsigned long)depth, SEND_BUFFER_SIZE);
+            canvas_draw_str_aligned(canvas, 126, 21, AlignRight, AlignBottom, counter);
+
+            // Keyboard, selected key inverted
+            for(uint8_t row = 0; row < SEND_KEYBOARD_ROWS; row++) {
+                for(uint8_t column = 0; SEND_KEYBOARD[row][column] != '\0'; column++) {
+                    int16_t x = 5 + column * SEND_KEY_WIDTH;
+                    int16_t y = 27 + row * SEND_KEY_HEIGHT;
+                    char key[2] = {SEND_KEYBOARD[row][column], '\0'};
+                    bool selected = (send->row == row + 1 && send->column == column);
+                    if(selected) {
+                        canvas_draw_box(canvas, x, y, SEND_KEY_WIDTH, SEND_KEY_HEIGHT - 1);
+                        canvas_set_color(canvas, ColorWhite);
+                    }
+                    canvas_draw_str_aligned(canvas, x + SEND_KEY_WIDTH / 2 + 1, y + 9, AlignCenter, AlignBottom, key);
+                    canvas_set_color(canvas, ColorBlack);
+                }
+            }
+            break;
+        }
+
+        case MorseStateQso: {
+            canvas_set_color(canvas, ColorWhite);
+            canvas_draw_box(canvas, 0, 0, 128, 64);
+            canvas_set_color(canvas, ColorBlack);
+            canvas_set_font(canvas, FontSecondary);
 
+            QsoBot* qso = &app->qso;
+            char line[32];
+            snprintf(line, sizeof(line), "%s: %s", qso->call, QSO_STATE_TITLES[qso->state]);
+            canvas_draw_str(canvas, 2, 9, line);
+            snprintf(line, sizeof(line), "%u WPM", qso->wpm);
+            canvas_draw_str_aligned(canvas, 126, 9, AlignRight, AlignBottom, line);
+            canvas_draw_line(canvas, 0, 11, 127, 11);
 
-            try_decode_morse(app);
+            canvas_draw_str(canvas, 2, 22, "Bot");
+            canvas_draw_str(canvas, 22, 22, app->send.sent);
+            canvas_draw_str(canvas, 2, 33, "You");
+            canvas_draw_str(canvas, 22, 33, qso->heard);
+            if(qso->key_down) canvas_draw_box(canvas, 122, 27, 5, 5);
 
-            canvas_draw_str(canvas, 5, 12, app->top_words);
+            uint32_t dot_ms = qso->decoder.dot_us / 1000;
+            snprintf(line, sizeof(line), "You %lu WPM", (unsigned long)(dot_ms ? 1200 / dot_ms : 0));
+            canvas_draw_str(canvas, 2, 46, line);
+            snprintf(line, sizeof(line), "Delay %u ms", qso->delay_ms);
+            canvas_draw_str_aligned(canvas, 126, 46, AlignRight, AlignBottom, line);
+            canvas_draw_str(canvas, 2, 60, "OK key </> delay ^v WPM");
+            break;
+        }
 
-            char current_status[64];
-            snprintf(current_status, sizeof(current_status), "%s", app->current_morse);
-            canvas_draw_str(canvas, 12, 36, current_status);
+        case MorseStateBenchmark: {
+            canvas_set_color(canvas, ColorWhite);
+            canvas_draw_box(canvas, 0, 0, 128, 64);
+            canvas_set_color(canvas, ColorBlack);
+            canvas_set_font(canvas, FontSecondary);
+
+            BenchSuite* bench = &app->bench;
+            char line[16];
+            canvas_draw_str(canvas, 2, 9, bench->running ? "Running..." : (bench->saved ? "Saved" : "Benchmark"));
+            canvas_draw_str_aligned(canvas, 74, 9, AlignRight, AlignBottom, "min");
+            canvas_draw_str_aligned(canvas, 100, 9, AlignRight, AlignBottom, "avg");
+            canvas_draw_str_aligned(canvas, 126, 9, AlignRight, AlignBottom, "p99");
+            canvas_draw_line(canvas, 0, 11, 127, 11);
+
+            for(uint8_t row = 0; row < BENCH_ROWS_SHOWN && bench->scroll + row < bench->result_count; row++) {
+                const BenchResult* result = &bench->results[bench->scroll + row];
+                int16_t y = 21 + row * 10;
+                canvas_draw_str(canvas, 2, y, result->name);
+                snprintf(line, sizeof(line), "%lu", (unsigned long)result->min);
+                canvas_draw_str_aligned(canvas, 74, y, AlignRight, AlignBottom, line);
+                snprintf(line, sizeof(line), "%lu", (unsigned long)result->avg);
+                canvas_draw_str_aligned(canvas, 100, y, AlignRight, AlignBottom, line);
+                snprintf(line, sizeof(line), "%lu", (unsigned long)result->p99);
+                canvas_draw_str_aligned(canvas, 126, y, AlignRight, AlignBottom, line);
+            }
+            break;
+        }
+
+        case MorseStateConfusions: {
+            canvas_set_color(canvas, ColorBlack);
+            canvas_draw_icon(canvas, 5, 6, &I_board);
+            canvas_draw_icon(canvas, 104, 52, &I_branch);
+            canvas_set_font(canvas, FontSecondary);
+
+            MorseConfusionPair pairs[CONFUSION_SHOWN];
+            uint8_t count = morse_confusion_worst(&app->confusion, pairs, CONFUSION_SHOWN);
+            canvas_draw_str(canvas, 12, 17, "Sent > keyed, OK: drill");
+            if(count == 0) {
+                canvas_draw_str(canvas, 12, 33, "No confusions yet,");
+                canvas_draw_str(canvas, 12, 42, "try the Echo drill");
+                break;
+            }
+
+            // Two columns of four, worst first
+            char line[16];
+            for(uint8_t i = 0; i < count; i++) {
+                char expected[4];
+                char received[4];
+                char_label(app, pairs[i].expected, false, expected, sizeof(expected));
+                char_label(app, pairs[i].received, false, received, sizeof(received));
+                snprintf(line, sizeof(line), "%s > %s  %u", expected, received, pairs[i].count);
+                canvas_draw_str(canvas, 12 + (i / 4) * 44, 27 + (i % 4) * 9, line);
+            }
+            break;
+        }
+
+        case MorseStateLessons: {
+            canvas_set_color(canvas, ColorBlack);
+            canvas_draw_icon(canvas, 5, 6, &I_board);
+            canvas_draw_icon(canvas, 104, 52, &I_branch);
+            canvas_set_font(canvas, FontSecondary);
 
+            LessonBrowser* lessons = &app->lessons;
+            char line[40];
+            int16_t x_offset = 12;
+
+            if(lessons->lesson_count == 0) {
+                canvas_draw_str(canvas, x_offset, 18, "No lesson pack found.");
+                canvas_draw_str(canvas, x_offset, 30, "Copy lessons.mlp to");
+                canvas_draw_str(canvas, x_offset, 39, "apps_data/morse_master");
+                break;
+            }
 
+            snprintf(line, sizeof(line), "%d/%d %.*s", lessons->selected + 1, lessons->lesson_count,
+                LESSON_TITLE_MAX, lessons->entry.title);
+            canvas_draw_str(canvas, x_offset, 18, line);
 
+            if(lessons->drill > 0) {
+                // Playing: drill text, wrapped by the marquee width
+                snprintf(line, sizeof(line), "Drill %d of %d", lessons->drill, lessons->header.drill_count);
+                canvas_draw_str(canvas, x_offset, 28, line);
+                canvas_set_font(canvas, FontPrimary);
+                snprintf(line, sizeof(line), "%.16s", lessons->text);
+                canvas_draw_str(canvas, x_offset, 41, line);
+                canvas_set_font(canvas, FontSecondary);
+                canvas_draw_str(canvas, x_offset, 53, "Back: stop");
+            } else {
+                snprintf(line, sizeof(line), "New: %.*s", LESSON_CHARS_MAX, lessons->header.new_chars);
+                canvas_draw_str(canvas, x_offset, 28, line);
+                snprintf(line, sizeof(line), "%d WPM, pass %d%%", lessons->header.target_wpm, lessons->header.pass_percent);
+                canvas_draw_str(canvas, x_offset, 37, line);
+                snprintf(line, sizeof(line), "%d drills", lessons->header.drill_count);
+                canvas_draw_str(canvas, x_offset, 46, line);
+                canvas_draw_str(canvas, x_offset, 55, "OK: play  </>: lesson");
+            }
             break;
         }
 
@@ -511,17 +4445,159 @@ static void morse_app_draw_callback(Canvas* canvas, void* ctx) {
         default:
             break;
     }
+
+    // Measured saving, once the screen is back
+    if(app->power.shown_tick && !probe) {
+        char line[32];
+        snprintf(line, sizeof(line), "Screen off: -%ld mAh/h", (long)app->power.saved_ma);
+        canvas_set_font(canvas, FontSecondary);
+        canvas_set_color(canvas, ColorWhite);
+        canvas_draw_box(canvas, 0, 53, 128, 11);
+        canvas_set_color(canvas, ColorBlack);
+        canvas_draw_frame(canvas, 0, 53, 128, 11);
+        canvas_draw_str_aligned(canvas, 64, 62, AlignCenter, AlignBottom, line);
+    }
+
+    if(probe) {
+        app->bench.draw_cycles = furi_hal_cortex_timer_get(0).start - draw_start;
+        app->bench.draw_done = true;
+    }
+}
+
+// Switch to a state and prepare it
+static void enter_state(MorseApp* app, MorseAppState state) {
+    app->app_state = state;
+    switch(state) {
+        case MorseStatePractice:
+            memset(app->user_input, 0, sizeof(app->user_input));
+            app->input_active = false; // Initialize to inactive
+            keylog_reset(app);
+            break;
+
+        case MorseStateReview:
+            review_build(app);
+            break;
+
+        case MorseStateLog:
+            qso_log_begin(app);
+            break;
+
+        case MorseStateBenchmark:
+            bench_start(app);
+            break;
+
+        case MorseStateSend: {
+            SendKeyer* send = &app->send;
+            send->head = 0;
+            send->tail = 0;
+            send->keying = 0;
+            send->drain = false;
+            memset(send->sent, 0, sizeof(send->sent));
+            send->row = 1;
+            send->column = 0;
+
+            // The sound worker keys from the buffer until the mode is left
+            app->sound_abort = false;
+            app->sound_busy = true;
+            SoundCommand cmd = SoundCommandSend;
+            if(furi_message_queue_put(app->sound_queue, &cmd, 0) != FuriStatusOk) {
+                app->sound_busy = false;
+            }
+            break;
+        }
+
+        case MorseStateQso:
+            qso_begin(app);
+            break;
+
+        case MorseStateFox:
+            app->fox.field = FoxFieldNumber;
+            break;
+
+        case MorseStateLadder:
+            app->ladder.phase = LadderPhaseSetup;
+            app->ladder.field = LadderFieldBase;
+            ladder_load_history(app);
+            break;
+
+        case MorseStateLessons:
+            app->lessons.drill = 0;
+            lessons_load_selected(app);
+            break;
+
+        case MorseStateListen:
+            listen_start(app);
+            break;
+
+        case MorseStateProgress:
+            progress_load(app);
+            break;
+
+        case MorseStateEcho:
+            app->echo.right = 0;
+            app->echo.total = 0;
+            app->echo.anchor = morse_charset_sample(echo_charset(app), &app->rng);
+            app->echo.round = 0;
+            echo_next(app);
+            break;
+
+        case MorseStateStream: {
+            // The sound worker streams the file, this thread only draws
+            MorseStream* stream = &app->stream;
+            stream->wpm = STREAM_DEFAULT_WPM;
+            stream->done = false;
+            stream->failed = false;
+            stream->characters = 0;
+            stream->first_element_us = -1;
+            memset(stream->text, 0, sizeof(stream->text));
+            morse_decoder_init(&stream->decoder, DECODER_DEFAULT_WPM, stream_decoded_callback, stream);
+            morse_filter_init(&stream->filter, &stream->decoder, app->filter_percent);
+
+            app->sound_abort = false;
+            app->sound_busy = true;
+            SoundCommand cmd = SoundCommandStream;
+            furi_message_queue_put(app->sound_queue, &cmd, 0);
+            break;
+        }
+
+        default:
+            break;
+    }
 }
 
-// Handle user input
+// GUI thread: stamp the event and hand it to the main loop. Key edges are
+// timed from the stamp, so a busy main loop delays them but never stretches them.
 static void morse_app_input_callback(InputEvent* input_event, void* ctx) {
     MorseApp* app = ctx;
+    MorseInputMessage message = {.input = *input_event, .time_us = morse_clock_us()};
+    if(furi_message_queue_put(app->event_queue, &message, 0) != FuriStatusOk) {
+        FURI_LOG_W("MorseMaster", "Input queue full, key dropped");
+    }
+}
+
+// Main loop side: handle user input
+static void morse_app_handle_input(MorseApp* app, InputEvent* input_event) {
     if(!app || !input_event) return;
 
+    // Holding DOWN in a training mode turns the screen off or back on. The
+    // firmware lights the backlight on every key, so it is switched off again.
+    if(input_event->key == InputKeyDown) {
+        if(input_event->type == InputTypeLong && stats_training_state(app->app_state)) {
+            app->screen_key_held = true;
+            screen_set(app, !app->screen_off);
+            return;
+        }
+        if(input_event->type == InputTypeRelease) app->screen_key_held = false;
+        if(app->screen_key_held) return;
+    }
+    if(app->screen_off && input_event->type == InputTypePress) {
+        notification_message(app->notifications, &sequence_display_backlight_off);
+    }
+
     // Update last input time for practice mode
     if(app->app_state == MorseStatePractice &&
        (input_event->key == InputKeyOk || input_event->key == InputKeyLeft)) {
-        app->last_input_time = furi_hal_rtc_get_timestamp();
+        app->last_input_time = app->input_time_us;
     }
 
     // Handle input_active state for practice mode animation
@@ -530,11 +4606,13 @@ static void morse_app_input_callback(InputEvent* input_event, void* ctx) {
             if(input_event->type == InputTypePress) {
                 // On press, activate the animation
                 app->input_active = true;
-                view_port_update(app->view_port);
+                keylog_edge(app, true);
+                morse_view_update(app);
             } else if(input_event->type == InputTypeRelease) {
                 // On release, deactivate the animation
                 app->input_active = false;
-                view_port_update(app->view_port);
+                keylog_edge(app, false);
+                morse_view_update(app);
             }
         }
     }
@@ -548,33 +4626,40 @@ static void morse_app_input_callback(InputEvent* input_event, void* ctx) {
             break;
 
         case MorseStateMenu:
-            if(input_event->key == InputKeyLeft && input_event->type == InputTypeShort) {
+            if(input_event->key == InputKeyOk && app->commander.enabled) {
+                // Straight key for commands; the sidetone follows the release
+                if(input_event->type == InputTypePress || input_event->type == InputTypeRelease) {
+                    command_edge(app, input_event->type == InputTypePress);
+                } else if(input_event->type == InputTypeShort) {
+                    play_dot(app);
+                } else if(input_event->type == InputTypeLong) {
+                    play_dash(app);
+                }
+            }
+            else if(input_event->key == InputKeyOk && input_event->type == InputTypeLong) {
+                // Morse control on; keying =SK turns it off again
+                app->commander.enabled = true;
+                command_start_key(app);
+                notification_message(app->notifications, &sequence_single_vibro);
+            }
+            else if(input_event->key == InputKeyLeft && input_event->type == InputTypeShort) {
                 // Move selection left (with wrap-around)
                 app->menu_selection = (app->menu_selection > 0) ?
-                    app->menu_selection - 1 : 2; // Wrap to last item
+                    app->menu_selection - 1 : menu_item_count(app) - 1; // Wrap to last item
             }
             else if(input_event->key == InputKeyRight && input_event->type == InputTypeShort) {
                 // Move selection right (with wrap-around)
-                app->menu_selection = (app->menu_selection < 2) ?
+                app->menu_selection = (app->menu_selection < menu_item_count(app) - 1) ?
                     app->menu_selection + 1 : 0; // Wrap to first item
             }
             else if(input_event->key == InputKeyOk && input_event->type == InputTypeShort) {
                 // Open the selected option
-                switch(app->menu_selection) {
-                    case 0: // Learn
-                        app->app_state = MorseStateLearn;
-                        break;
-
-                    case 1: // Practice
-                        app->app_state = MorseStatePractice;
-                        memset(app->user_input, 0, sizeof(app->user_input));
-                        app->input_active = false; // Initialize to inactive
-                        break;
-
-                    case 2: // Help
-                        app->app_state = MorseStateHelp;
-                        break;
-                }
+                enter_state(app, MENU_ITEMS[app->menu_selection].state);
+            }
+            else if(input_event->key == InputKeyUp && input_event->type == InputTypeLong) {
+                // Show or hide the developer entries
+                app->menu_unlocked = !app->menu_unlocked;
+                if(app->menu_selection >= menu_item_count(app)) app->menu_selection = 0;
             }
             else if(input_event->key == InputKeyBack && input_event->type == InputTypeShort) {
                 app->is_running = false;
@@ -585,48 +4670,36 @@ static void morse_app_input_callback(InputEvent* input_event, void* ctx) {
             if(input_event->key == InputKeyOk && input_event->type == InputTypeShort) {
                 // Play the character's morse code
                 play_character(app, app->current_char);
+                stats_add_characters(app, 1, 0, 0);
             }
-            else if(input_event->key == InputKeyUp && input_event->type == InputTypeShort) {
-                // Switch to letters mode
-                app->learning_letters_mode = true;
-                app->current_char = 'A';
+            else if(input_event->key == InputKeyOk && input_event->type == InputTypeLong) {
+                // Jump to a random character of the current set and play it
+                int index = morse_charset_sample(learn_charset(app), &app->rng);
+                if(index >= 0) app->current_char = MORSE_TABLE[index].character;
+                play_character(app, app->current_char);
+                stats_add_characters(app, 1, 0, 0);
             }
-            else if(input_event->key == InputKeyDown && input_event->type == InputTypeShort) {
-                // Switch to numbers mode
-                app->learning_letters_mode = false;
-                app->current_char = '0';
+            else if((input_event->key == InputKeyUp || input_event->key == InputKeyDown) &&
+                    input_event->type == InputTypeShort) {
+                // Switch set, starting from its first character
+                app->learn_set = learn_set_step(app, input_event->key == InputKeyUp ? -1 : 1);
+                int index = morse_charset_next(learn_charset(app), -1);
+                if(index >= 0) app->current_char = MORSE_TABLE[index].character;
             }
-            else if(input_event->key == InputKeyRight && input_event->type == InputTypeShort) {
-                // Show next character based on current mode
-                if (app->learning_letters_mode) {
-                    // Letters mode
-                    if(app->current_char == 'Z')
-                        app->current_char = 'A';
-                    else
-                        app->current_char++;
-                } else {
-                    // Numbers mode
-                    if(app->current_char == '9')
-                        app->current_char = '0';
-                    else
-                        app->current_char++;
-                }
+            else if((input_event->key == InputKeyRight || input_event->key == InputKeyLeft) &&
+                    input_event->type == InputTypeShort) {
+                // Next or previous character of the set, wrapping
+                MorseCharset set = learn_charset(app);
+                int index = get_table_index_for_char(app->current_char);
+                index = (input_event->key == InputKeyRight) ? morse_charset_next(set, index) :
+                                                              morse_charset_previous(set, index);
+                if(index >= 0) app->current_char = MORSE_TABLE[index].character;
             }
-            else if(input_event->key == InputKeyLeft && input_event->type == InputTypeShort) {
-                // Show previous character based on current mode
-                if (app->learning_letters_mode) {
-                    // Letters mode
-                    if(app->current_char == 'A')
-                        app->current_char = 'Z';
-                    else
-                        app->current_char--;
-                } else {
-                    // Numbers mode
-                    if(app->current_char == '0')
-                        app->current_char = '9';
-                    else
-                        app->current_char--;
-                }
+            else if(input_event->key == InputKeyRight && input_event->type == InputTypeLong) {
+                // Add the character to the user's own set, or take it out
+                int index = get_table_index_for_char(app->current_char);
+                if(index >= 0) app->learn_custom ^= MORSE_CHARSET_BIT(index);
+                notification_message(app->notifications, &sequence_single_vibro);
             }
             else if(input_event->key == InputKeyBack && input_event->type == InputTypeShort) {
                 app->app_state = MorseStateMenu;
@@ -646,7 +4719,7 @@ static void morse_app_input_callback(InputEvent* input_event, void* ctx) {
                 }
 
                 // Update last input time
-                app->last_input_time = furi_hal_rtc_get_timestamp();
+                app->last_input_time = app->input_time_us;
 
                 // Check if input has reached MAX_MORSE_LENGTH
                 if(app->input_position >= MAX_MORSE_LENGTH - 1) {
@@ -655,9 +4728,7 @@ static void morse_app_input_callback(InputEvent* input_event, void* ctx) {
                     app->input_position = 0;
 
                     // Show visual feedback (flash green LED) to indicate input was cleared
-                    notification_message(app->notifications, &sequence_set_only_green_255);
-                    furi_delay_ms(200);
-                    notification_message(app->notifications, &sequence_reset_green);
+                    notification_message(app->notifications, &sequence_flash_green_200);
                 }
 
                 if(input_event->type == InputTypeShort) {
@@ -710,21 +4781,400 @@ static void morse_app_input_callback(InputEvent* input_event, void* ctx) {
                 // Increase volume (with upper limit)
                 app->volume = (app->volume < 1.0f) ? app->volume + 0.25f : 1.0f;
                 if (app->volume > 1.0f) app->volume = 1.0f; // Make sure we don't exceed 1.0
-                notification_message(app->notifications, &sequence_set_only_green_255);
-                furi_delay_ms(100);
-                notification_message(app->notifications, &sequence_reset_green);
+                notification_message(app->notifications, &sequence_flash_green_100);
             }
             else if(input_event->key == InputKeyDown && input_event->type == InputTypeShort) {
                 // Decrease volume (with lower limit of 0.0f for mute)
                 app->volume = (app->volume > 0.0f) ? app->volume - 0.25f : 0.0f;
                 if (app->volume < 0.0f) app->volume = 0.0f; // Make sure we don't go below 0
-                notification_message(app->notifications, &sequence_set_only_green_255);
-                furi_delay_ms(100);
-                notification_message(app->notifications, &sequence_reset_green);
+                notification_message(app->notifications, &sequence_flash_green_100);
             }
             else if(input_event->key == InputKeyBack && input_event->type == InputTypeShort) {
                 app->app_state = MorseStateMenu;
             }
+            else if(input_event->key == InputKeyBack && input_event->type == InputTypeLong) {
+                // Hear the session back
+                enter_state(app, MorseStateReview);
+            }
+            break;
+
+        case MorseStateFox: {
+            FoxHunt* fox = &app->fox;
+            if(input_event->type != InputTypeShort) break;
+
+            if(input_event->key == InputKeyOk) {
+                // Start or stop the transmitter
+                if(fox->running) {
+                    fox_stop(app);
+                } else {
+                    fox_start(app);
+                }
+            }
+            else if(input_event->key == InputKeyBack) {
+                fox_stop(app);
+                app->app_state = MorseStateMenu;
+            }
+            else if(fox->running) {
+                // Config is locked while the transmitter runs
+                break;
+            }
+            else if(input_event->key == InputKeyUp) {
+                fox->field = (fox->field > 0) ? fox->field - 1 : FoxFieldCount - 1;
+            }
+            else if(input_event->key == InputKeyDown) {
+                fox->field = (fox->field < FoxFieldCount - 1) ? fox->field + 1 : 0;
+            }
+            else if(input_event->key == InputKeyLeft || input_event->key == InputKeyRight) {
+                int step = (input_event->key == InputKeyRight) ? 1 : -1;
+                switch(fox->field) {
+                    case FoxFieldNumber:
+                        fox->number = (fox->number + fox->foxes - 1 + step) % fox->foxes + 1;
+                        break;
+                    case FoxFieldFoxes:
+                        fox->foxes += step;
+                        if(fox->foxes < FOX_MIN_FOXES) fox->foxes = FOX_MAX_FOXES;
+                        if(fox->foxes > FOX_MAX_FOXES) fox->foxes = FOX_MIN_FOXES;
+                        if(fox->number > fox->foxes) fox->number = fox->foxes;
+                        break;
+                    case FoxFieldSpeed:
+                        fox->wpm += step;
+                        if(fox->wpm < MIN_WPM) fox->wpm = MIN_WPM;
+                        if(fox->wpm > MAX_WPM) fox->wpm = MAX_WPM;
+                        break;
+                    default:
+                        fox->gpio = !fox->gpio;
+                        break;
+                }
+            }
+            break;
+        }
+
+        case MorseStateLadder: {
+            LadderTest* ladder = &app->ladder;
+            if(input_event->type != InputTypeShort) break;
+
+            if(input_event->key == InputKeyBack) {
+                // Leave the test, or the screen from setup
+                app->sound_abort = true;
+                if(ladder->phase == LadderPhaseSetup) {
+                    app->app_state = MorseStateMenu;
+                } else {
+                    ladder->phase = LadderPhaseSetup;
+                }
+                break;
+            }
+
+            switch(ladder->phase) {
+                case LadderPhaseSetup:
+                    if(input_event->key == InputKeyOk) {
+                        ladder_start(app);
+                    } else if(input_event->key == InputKeyUp) {
+                        ladder->field = (ladder->field > 0) ? ladder->field - 1 : LadderFieldCount - 1;
+                    } else if(input_event->key == InputKeyDown) {
+                        ladder->field = (ladder->field < LadderFieldCount - 1) ? ladder->field + 1 : 0;
+                    } else if(input_event->key == InputKeyLeft || input_event->key == InputKeyRight) {
+                        int step = (input_event->key == InputKeyRight) ? 1 : -1;
+                        if(ladder->field == LadderFieldBase) {
+                            ladder->base_wpm += step;
+                            if(ladder->base_wpm < MIN_WPM) ladder->base_wpm = MIN_WPM;
+                            if(ladder->base_wpm > MAX_WPM) ladder->base_wpm = MAX_WPM;
+                        } else if(ladder->field == LadderFieldStep) {
+                            ladder->step_wpm += step;
+                            if(ladder->step_wpm < 1) ladder->step_wpm = 1;
+                            if(ladder->step_wpm > LADDER_MAX_STEP_WPM) ladder->step_wpm = LADDER_MAX_STEP_WPM;
+                        } else {
+                            ladder->max_misses += step;
+                            if(ladder->max_misses < 1) ladder->max_misses = 1;
+                            if(ladder->max_misses > LADDER_MAX_MISSES) ladder->max_misses = LADDER_MAX_MISSES;
+                        }
+                    }
+                    break;
+
+                case LadderPhaseGrading:
+                    if(input_event->key == InputKeyRight) {
+                        ladder_grade(app, true);
+                    } else if(input_event->key == InputKeyLeft) {
+                        ladder_grade(app, false);
+                    }
+                    break;
+
+                case LadderPhaseDone:
+                    if(input_event->key == InputKeyOk) {
+                        ladder->phase = LadderPhaseSetup;
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+            break;
+        }
+
+        case MorseStateLessons: {
+            LessonBrowser* lessons = &app->lessons;
+            if(input_event->type != InputTypeShort) break;
+
+            if(input_event->key == InputKeyBack) {
+                // Stop a playing lesson first, then leave
+                if(app->sound_busy) {
+                    app->sound_abort = true;
+                } else {
+                    app->app_state = MorseStateMenu;
+                }
+            } else if(app->sound_busy || lessons->lesson_count == 0) {
+                break;
+            } else if(input_event->key == InputKeyOk) {
+                app->sound_abort = false;
+                app->sound_busy = true;
+                SoundCommand cmd = SoundCommandLesson;
+                furi_message_queue_put(app->sound_queue, &cmd, 0);
+            } else if(input_event->key == InputKeyLeft || input_event->key == InputKeyUp) {
+                lessons->selected = (lessons->selected > 0) ? lessons->selected - 1 : lessons->lesson_count - 1;
+                lessons_load_selected(app);
+            } else if(input_event->key == InputKeyRight || input_event->key == InputKeyDown) {
+                lessons->selected = (lessons->selected + 1 < lessons->lesson_count) ? lessons->selected + 1 : 0;
+                lessons_load_selected(app);
+            }
+            break;
+        }
+
+        case MorseStateListen:
+            if(input_event->type != InputTypeShort) break;
+            if(input_event->key == InputKeyOk) {
+                // Clear the text and search for a new carrier
+                listen_stop(app);
+                listen_start(app);
+            } else if(input_event->key == InputKeyUp || input_event->key == InputKeyDown) {
+                // Glitch filter strength, from the next run on
+                if(input_event->key == InputKeyUp && app->filter_percent + GLITCH_STEP_PERCENT <= GLITCH_MAX_PERCENT) {
+                    app->filter_percent += GLITCH_STEP_PERCENT;
+                }
+                if(input_event->key == InputKeyDown && app->filter_percent >= GLITCH_STEP_PERCENT) {
+                    app->filter_percent -= GLITCH_STEP_PERCENT;
+                }
+                app->listen.filter.percent = app->filter_percent;
+            } else if(input_event->key == InputKeyLeft) {
+                // Meanings of abbreviations and Q-codes on or off
+                app->glossary = !app->glossary;
+                app->listen.glossary = app->glossary;
+            } else if(input_event->key == InputKeyRight) {
+                // Log the contact just heard
+                listen_stop(app);
+                enter_state(app, MorseStateLog);
+            } else if(input_event->key == InputKeyBack) {
+                listen_stop(app);
+                app->app_state = MorseStateMenu;
+            }
+            break;
+
+        case MorseStateProgress: {
+            ProgressGraph* graph = &app->progress;
+            if(input_event->type != InputTypeShort) break;
+            if(input_event->key == InputKeyUp) {
+                graph->metric = (graph->metric > 0) ? graph->metric - 1 : ProgressMetricCount - 1;
+            } else if(input_event->key == InputKeyDown) {
+                graph->metric = (graph->metric < ProgressMetricCount - 1) ? graph->metric + 1 : 0;
+            } else if(input_event->key == InputKeyLeft || input_event->key == InputKeyRight) {
+                graph->days = (graph->days == PROGRESS_SHORT_DAYS) ? PROGRESS_LONG_DAYS : PROGRESS_SHORT_DAYS;
+                progress_load(app);
+            } else if(input_event->key == InputKeyBack) {
+                app->app_state = MorseStateMenu;
+            }
+            break;
+        }
+
+        case MorseStateEcho: {
+            EchoDrill* echo = &app->echo;
+            if(input_event->key == InputKeyOk && input_event->type == InputTypeShort) {
+                echo_key(app, '.');
+            } else if(input_event->key == InputKeyOk && input_event->type == InputTypeLong) {
+                echo_key(app, '-');
+            } else if(input_event->type != InputTypeShort) {
+                break;
+            } else if(input_event->key == InputKeyLeft) {
+                play_character(app, echo->target);
+            } else if(input_event->key == InputKeyUp || input_event->key == InputKeyDown) {
+                echo->source = (input_event->key == InputKeyUp) ?
+                                   (echo->source + EchoSourceCount - 1) % EchoSourceCount :
+                                   (echo->source + 1) % EchoSourceCount;
+                echo->anchor = morse_charset_sample(echo_charset(app), &app->rng);
+                echo->round = 0;
+                echo_next(app);
+            } else if(input_event->key == InputKeyBack) {
+                app->app_state = MorseStateMenu;
+            }
+            break;
+        }
+
+        case MorseStateReview:
+            if(input_event->type != InputTypeShort) break;
+            if(input_event->key == InputKeyOk) {
+                review_start(app, ReviewPlayBoth);
+            } else if(input_event->key == InputKeyLeft) {
+                review_start(app, ReviewPlayOwn);
+            } else if(input_event->key == InputKeyRight) {
+                review_start(app, ReviewPlayIdeal);
+            } else if(input_event->key == InputKeyUp || input_event->key == InputKeyDown) {
+                // Takes effect from the next Practice session
+                app->keylog.spill = !app->keylog.spill;
+            } else if(input_event->key == InputKeyBack) {
+                app->sound_abort = true;
+                app->app_state = MorseStateMenu;
+            }
+            break;
+
+        case MorseStateLog: {
+            QsoLog* log = &app->log;
+            size_t max = 0;
+            char* text = qso_log_text(log, log->field, &max);
+
+            if(input_event->key == InputKeyOk && input_event->type == InputTypeLong) {
+                log->editing = false;
+                qso_log_commit(app);
+                break;
+            }
+            if(input_event->type != InputTypeShort && input_event->type != InputTypeRepeat) break;
+
+            if(log->editing) {
+                if(input_event->key == InputKeyUp) {
+                    qso_log_edit(log, 1);
+                } else if(input_event->key == InputKeyDown) {
+                    qso_log_edit(log, -1);
+                } else if(input_event->key == InputKeyLeft) {
+                    if(log->cursor > 0) log->cursor--;
+                } else if(input_event->key == InputKeyRight) {
+                    if(log->cursor + 1u < max && log->cursor < strlen(text)) log->cursor++;
+                } else if(input_event->type == InputTypeShort) {
+                    log->editing = false;
+                }
+            } else if(input_event->key == InputKeyUp) {
+                log->field = (log->field > 0) ? log->field - 1 : LogFieldCount - 1;
+            } else if(input_event->key == InputKeyDown) {
+                log->field = (log->field + 1 < LogFieldCount) ? log->field + 1 : 0;
+            } else if(!text && (input_event->key == InputKeyLeft || input_event->key == InputKeyRight)) {
+                log->band = (input_event->key == InputKeyRight) ? (log->band + 1) % ADIF_BAND_COUNT :
+                                                                  (log->band + ADIF_BAND_COUNT - 1) % ADIF_BAND_COUNT;
+            } else if(input_event->type != InputTypeShort) {
+                break;
+            } else if(input_event->key == InputKeyOk && text) {
+                log->editing = true;
+                log->cursor = (uint8_t)strlen(text);
+                if(log->cursor >= max) log->cursor = max - 1;
+            } else if(input_event->key == InputKeyBack) {
+                // Records reach the SD card when the log is left
+                adif_writer_flush(&log->writer);
+                app->app_state = MorseStateMenu;
+            }
+            break;
+        }
+
+        case MorseStateSend: {
+            SendKeyer* send = &app->send;
+            if(input_event->key == InputKeyOk && input_event->type == InputTypeLong) {
+                send_delete(send);
+                break;
+            }
+            if(input_event->type != InputTypeShort && input_event->type != InputTypeRepeat) break;
+
+            uint8_t columns = send->row ? strlen(SEND_KEYBOARD[send->row - 1]) : 1;
+            if(input_event->key == InputKeyUp) {
+                send->row = (send->row > 0) ? send->row - 1 : SEND_KEYBOARD_ROWS;
+            } else if(input_event->key == InputKeyDown) {
+                send->row = (send->row < SEND_KEYBOARD_ROWS) ? send->row + 1 : 0;
+            } else if(send->row == 0 && (input_event->key == InputKeyLeft || input_event->key == InputKeyRight)) {
+                // Speed applies from the next character
+                if(input_event->key == InputKeyRight && send->wpm < MAX_WPM) send->wpm++;
+                if(input_event->key == InputKeyLeft && send->wpm > MIN_WPM) send->wpm--;
+            } else if(input_event->key == InputKeyLeft) {
+                send->column = (send->column > 0) ? send->column - 1 : columns - 1;
+            } else if(input_event->key == InputKeyRight) {
+                send->column = (send->column + 1 < columns) ? send->column + 1 : 0;
+            } else if(input_event->type != InputTypeShort) {
+                break;
+            } else if(input_event->key == InputKeyOk && send->row > 0) {
+                char key = SEND_KEYBOARD[send->row - 1][send->column];
+                if(key == '<') {
+                    send_delete(send);
+                } else if(!send_type(send, key == '_' ? ' ' : key)) {
+                    notification_message(app->notifications, &sequence_blink_red_100);
+                }
+            } else if(input_event->key == InputKeyBack) {
+                // Stops after the element on the air, the rest of the buffer is dropped
+                app->sound_abort = true;
+                app->app_state = MorseStateMenu;
+            }
+
+            // Rows differ in length, keep the column on a key
+            if(send->row > 0) {
+                uint8_t row_columns = strlen(SEND_KEYBOARD[send->row - 1]);
+                if(send->column >= row_columns) send->column = row_columns - 1;
+            }
+            break;
+        }
+
+        case MorseStateQso: {
+            QsoBot* qso = &app->qso;
+            if(input_event->key == InputKeyOk) {
+                // A straight key while the bot is not sending; the sidetone follows the release
+                if(app->sound_busy) break;
+                if(input_event->type == InputTypePress || input_event->type == InputTypeRelease) {
+                    qso_edge(app, input_event->type == InputTypePress);
+                } else if(input_event->type == InputTypeShort) {
+                    play_dot(app);
+                } else if(input_event->type == InputTypeLong) {
+                    play_dash(app);
+                }
+            } else if(input_event->type != InputTypeShort && input_event->type != InputTypeRepeat) {
+                break;
+            } else if(input_event->key == InputKeyLeft) {
+                if(qso->delay_ms >= QSO_DELAY_STEP_MS) qso->delay_ms -= QSO_DELAY_STEP_MS;
+            } else if(input_event->key == InputKeyRight) {
+                if(qso->delay_ms + QSO_DELAY_STEP_MS <= QSO_DELAY_MAX_MS) qso->delay_ms += QSO_DELAY_STEP_MS;
+            } else if(input_event->key == InputKeyUp) {
+                if(qso->wpm < MAX_WPM) qso->wpm++;
+            } else if(input_event->key == InputKeyDown) {
+                if(qso->wpm > MIN_WPM) qso->wpm--;
+            } else if(input_event->key == InputKeyBack && input_event->type == InputTypeShort) {
+                app->sound_abort = true;
+                app->app_state = MorseStateMenu;
+            }
+            break;
+        }
+
+        case MorseStateBenchmark: {
+            BenchSuite* bench = &app->bench;
+            if(input_event->type != InputTypeShort && input_event->type != InputTypeRepeat) break;
+            if(input_event->key == InputKeyUp) {
+                if(bench->scroll > 0) bench->scroll--;
+            } else if(input_event->key == InputKeyDown) {
+                if(bench->scroll + BENCH_ROWS_SHOWN < bench->result_count) bench->scroll++;
+            } else if(input_event->type != InputTypeShort) {
+                break;
+            } else if(input_event->key == InputKeyOk && !bench->running) {
+                bench_start(app);
+            } else if(input_event->key == InputKeyBack) {
+                bench_stop(app);
+                app->app_state = MorseStateMenu;
+            }
+            break;
+        }
+
+        case MorseStateConfusions:
+            if(input_event->type != InputTypeShort) break;
+            if(input_event->key == InputKeyOk) {
+                app->echo.source = EchoSourceConfusions;
+                enter_state(app, MorseStateEcho);
+            } else if(input_event->key == InputKeyBack) {
+                app->app_state = MorseStateMenu;
+            }
+            break;
+
+        case MorseStateStream:
+            if(input_event->key == InputKeyBack && input_event->type == InputTypeShort) {
+                // Stop streaming and continue in the menu
+                app->sound_abort = true;
+                app->app_state = MorseStateMenu;
+            }
             break;
 
         case MorseStateHelp:
@@ -737,12 +5187,13 @@ static void morse_app_input_callback(InputEvent* input_event, void* ctx) {
             break;
     }
 
-    view_port_update(app->view_port);
+    morse_view_update(app);
 }
 
 // Entry point for Morse Master application
 int32_t morse_master_app(void* p) {
-    UNUSED(p);
+    const char* args = p;
+    uint32_t launch_us = morse_clock_us();
     FURI_LOG_I("MorseMaster", "Application starting");
 
     MorseApp* app = malloc(sizeof(MorseApp));
@@ -757,16 +5208,18 @@ int32_t morse_master_app(void* p) {
     // Allocate required resources
     app->gui = furi_record_open(RECORD_GUI);
     app->view_port = view_port_alloc();
-    app->event_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
+    app->event_queue = furi_message_queue_alloc(INPUT_QUEUE_SIZE, sizeof(MorseInputMessage));
     app->notifications = furi_record_open(RECORD_NOTIFICATION);
     app->sound_queue = furi_message_queue_alloc(8, sizeof(SoundCommand));
+    app->save_queue = furi_message_queue_alloc(SAVE_QUEUE_SIZE, sizeof(SaveJob));
 
     // Check if all resources were allocated
-    if(!app->view_port || !app->event_queue || !app->sound_queue) {
+    if(!app->view_port || !app->event_queue || !app->sound_queue || !app->save_queue) {
         FURI_LOG_E("MorseMaster", "Failed to allocate resources");
         if(app->view_port) view_port_free(app->view_port);
         if(app->event_queue) furi_message_queue_free(app->event_queue);
         if(app->sound_queue) furi_message_queue_free(app->sound_queue);
+        if(app->save_queue) furi_message_queue_free(app->save_queue);
         if(app->gui) furi_record_close(RECORD_GUI);
         if(app->notifications) furi_record_close(RECORD_NOTIFICATION);
         free(app);
@@ -780,48 +5233,135 @@ int32_t morse_master_app(void* p) {
     app->sound_running = true;
     app->input_active = false;  // Initialize input_active flag
     app->current_char = 'A'; // Start with A instead of E
-    app->learning_letters_mode = true; // Start in letters mode
+    app->learn_set = 0; // Start with the letters
     app->input_position = 0;
     app->last_input_time = 0;
     app->current_morse_position = 0;
     app->auto_add_space = false;
     app->volume = INITIAL_VOLUME; // Initialize volume to max
+    app->fox.number = 1;
+    app->fox.foxes = FOX_MAX_FOXES;
+    app->fox.wpm = FOX_DEFAULT_WPM;
+    app->ladder.base_wpm = LADDER_DEFAULT_BASE_WPM;
+    app->ladder.step_wpm = LADDER_DEFAULT_STEP_WPM;
+    app->ladder.max_misses = LADDER_DEFAULT_MISSES;
+    app->progress.days = PROGRESS_SHORT_DAYS;
+    app->log.band = 5;  // 20m
+    app->send.wpm = SEND_DEFAULT_WPM;
+    app->send.mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    app->qso.delay_ms = QSO_DEFAULT_DELAY_MS;
+    app->filter_percent = GLITCH_DEFAULT_PERCENT;
+    app->glossary = true;
+    command_init(app);
+    adif_writer_init(&app->log.writer, qso_log_write, NULL);
     memset(app->user_input, 0, sizeof(app->user_input));
     memset(app->decoded_text, 0, sizeof(app->decoded_text));
     memset(app->top_words, 0, sizeof(app->top_words));
     memset(app->current_morse, 0, sizeof(app->current_morse));
 
+    // Rasterise every code once so drawing is a plain blit
+    for(size_t i = 0; i < MORSE_TABLE_SIZE; i++) {
+        render_glyph(&app->glyph_cache[i], MORSE_TABLE[i].code, GLYPH_LEARN_WIDTH);
+    }
+    morse_similarity_init(&app->similarity);
+
     // Configure viewport
     view_port_draw_callback_set(app->view_port, morse_app_draw_callback, app);
     view_port_input_callback_set(app->view_port, morse_app_input_callback, app);
     gui_add_view_port(app->gui, app->view_port, GuiLayerFullscreen);
 
     // Create and start sound worker thread
-    app->sound_thread = furi_thread_alloc_ex("MorseSoundWorker", 1024, sound_worker_thread, app);
+    app->sound_thread = furi_thread_alloc_ex("MorseSoundWorker", 2048, sound_worker_thread, app);
     furi_thread_start(app->sound_thread);
 
-    // Seed RNG
-    srand(furi_hal_rtc_get_timestamp());
+    // Continue today's statistics if the app already ran today
+    app->stats.day = stats_current_day();
+    app->stats.last_tick = furi_get_tick();
+    app->stats.last_state = app->app_state;
+    stats_load(app);
+    confusion_load(app);
+    bool resumed = resume_load(app);
+
+    // SD writes from here on go through the save worker
+    app->save_thread = furi_thread_alloc_ex("MorseSaveWorker", 2048, save_worker_thread, app);
+    furi_thread_start(app->save_thread);
+
+    // Seed the generator, every session can be replayed from its seed
+    start_session(app, furi_hal_rtc_get_timestamp() ^ furi_get_tick());
+    if(furi_hal_rtc_is_flag_set(FuriHalRtcFlagDebug)) {
+        benchmark_rng();
+    }
+
+    // A file path or mode name skips the title screen and menu; otherwise the
+    // last session continues, in the mode it was left in
+    app->stream.launch_us = launch_us;
+    bool launched = args && args[0] != '\0';
+    if(launched && !apply_launch_argument(app, args)) {
+        FURI_LOG_W("MorseMaster", "Unknown launch argument: %s", args);
+    }
+    if(resumed) resume_apply(app, !launched);
+    app->resume.write_tick = furi_get_tick();
 
     // Main event loop
     while(app->is_running) {
-        InputEvent event;
-        // Wait for input with a timeout
-        if(furi_message_queue_get(app->event_queue, &event, 100) == FuriStatusOk) {
-            morse_app_input_callback(&event, app);
+        MorseInputMessage message;
+        // Wait for input with a timeout, cut short when the QSO Bot is due
+        uint32_t wait_ms = 100;
+        if(app->app_state == MorseStateQso) wait_ms = qso_wait_ms(app, wait_ms);
+        if(furi_message_queue_get(app->event_queue, &message, furi_ms_to_ticks(wait_ms)) == FuriStatusOk) {
+            app->input_time_us = message.time_us;
+            morse_app_handle_input(app, &message.input);
         } else {
             // No input - check if we need to decode morse after a pause
             if(app->app_state == MorseStatePractice) {
-                view_port_update(app->view_port);  // Update to check for decoding
+                morse_view_update(app);  // Keep the decoded text current
+            } else if(app->app_state == MorseStateFox && app->fox.running) {
+                morse_view_update(app);  // Keep the slot countdown ticking
+            } else if(app->app_state == MorseStateListen) {
+                morse_view_update(app);  // Pitch, level and decoded text
             }
         }
-        furi_delay_ms(5); // Small delay to prevent CPU hogging
+
+        stats_tick(app);
+        power_tick(app);
+        if(app->app_state == MorseStatePractice) try_decode_morse(app);
+        if(app->app_state == MorseStateEcho) echo_tick(app);
+        if(app->app_state == MorseStateQso) qso_tick(app);
+        command_tick(app);
+        keylog_spill(app, app->app_state != MorseStatePractice);
+        resume_tick(app, false);
+
+        // Ask for a verdict once the ladder group has finished keying
+        if(app->app_state == MorseStateLadder && app->ladder.phase == LadderPhasePlaying && !app->sound_busy) {
+            app->ladder.phase = LadderPhaseGrading;
+            morse_view_update(app);
+        }
     }
 
+    // Stop the fox transmitter, the audio input and the benchmark if they are still running
+    fox_stop(app);
+    listen_stop(app);
+    bench_stop(app);
+
+    // Keep the day's numbers
+    stats_tick(app);
+    stats_roll_day(app);
+    stats_save(app);
+    keylog_spill(app, true);
+    adif_writer_flush(&app->log.writer);
+    resume_tick(app, true);
+
+    // Let the save worker finish what is queued
+    SaveJob stop = {.type = SaveJobStop};
+    furi_message_queue_put(app->save_queue, &stop, FuriWaitForever);
+    furi_thread_join(app->save_thread);
+    furi_thread_free(app->save_thread);
+
     // Signal sound thread to stop and wait for it to finish
     app->sound_running = false;
     furi_thread_join(app->sound_thread);
     furi_thread_free(app->sound_thread);
+    furi_mutex_free(app->send.mutex);
 
     // Free resources
     view_port_enabled_set(app->view_port, false);
@@ -829,6 +5369,7 @@ int32_t morse_master_app(void* p) {
     view_port_free(app->view_port);
     furi_message_queue_free(app->event_queue);
     furi_message_queue_free(app->sound_queue);
+    furi_message_queue_free(app->save_queue);
     furi_record_close(RECORD_GUI);
     furi_record_close(RECORD_NOTIFICATION);
     free(app);
@@ -836,22 +5377,25 @@ int32_t morse_master_app(void* p) {
     return 0;
 }
 
-// Function to update the top words marquee buffer
-static void update_top_words_marquee(MorseApp* app, char new_char) {
+// Append to a marquee buffer of max_length characters (buffer holds max_length + 1)
+static void marquee_push(char* buffer, size_t max_length, char new_char) {
     // If there's room in the buffer, just append
-    size_t len = strlen(app->top_words);
+    size_t len = strlen(buffer);
 
-    if(len < TOP_WORDS_MAX_LENGTH) {
+    if(len < max_length) {
         // There's still room, just append
-        app->top_words[len] = new_char;
-        app->top_words[len + 1] = '\0';
+        buffer[len] = new_char;
+        buffer[len + 1] = '\0';
     } else {
         // Shift characters left by one position
-        for(size_t i = 0; i < TOP_WORDS_MAX_LENGTH - 1; i++) {
-            app->top_words[i] = app->top_words[i + 1];
-        }
+        memmove(buffer, buffer + 1, max_length - 1);
         // Add the new character at the end
-        app->top_words[TOP_WORDS_MAX_LENGTH - 1] = new_char;
-        app->top_words[TOP_WORDS_MAX_LENGTH] = '\0';
+        buffer[max_length - 1] = new_char;
+        buffer[max_length] = '\0';
     }
 }
+
+// Function to update the top words marquee buffer
+static void update_top_words_marquee(MorseApp* app, char new_char) {
+    marquee_push(app->top_words, TOP_WORDS_MAX_LENGTH, new_char);
+}
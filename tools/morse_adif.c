@@ -0,0 +1,76 @@
+// Host-side ADIF writer: turns decoded transcripts into QSO records with the
+// same prefill and writer as the app, so the output can be diffed against a
+// reference log. Build with `make` in this directory.
+//
+// Each input line is one contact's transcript. Records are timed from -t and
+// one minute apart, so a run is reproducible.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "morse_adif.h"
+
+static bool write_stdout(const char* data, size_t length, void* context) {
+    (void)context;
+    return fwrite(data, 1, length, stdout) == length;
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: morse_adif [-b band] [-s rst_sent] [-t unix_time] [transcript.txt]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* band = "20m";
+    const char* rst_sent = "599";
+    uint32_t timestamp = 0;
+    const char* path = NULL;
+
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            band = argv[++i];
+        } else if(strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            rst_sent = argv[++i];
+        } else if(strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            timestamp = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if(argv[i][0] == '-' || path) {
+            usage();
+            return 1;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    FILE* input = path ? fopen(path, "r") : stdin;
+    if(!input) {
+        perror(path);
+        return 1;
+    }
+
+    char header[128];
+    fwrite(header, 1, adif_header(header, sizeof(header), "Morse Master"), stdout);
+
+    AdifWriter writer;
+    adif_writer_init(&writer, write_stdout, NULL);
+    char line[512];
+    unsigned records = 0;
+    while(fgets(line, sizeof(line), input)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if(line[0] == '\0') continue;
+
+        AdifQso qso = {.timestamp = timestamp + records * 60};
+        snprintf(qso.band, sizeof(qso.band), "%s", band);
+        snprintf(qso.rst_sent, sizeof(qso.rst_sent), "%s", rst_sent);
+        adif_prefill(&qso, line);
+        if(!adif_writer_append(&writer, &qso)) {
+            fprintf(stderr, "record %u could not be written\n", records + 1);
+            return 1;
+        }
+        records++;
+    }
+    bool ok = adif_writer_flush(&writer);
+
+    if(input != stdin) fclose(input);
+    fprintf(stderr, "%u records\n", records);
+    return ok ? 0 : 1;
+}
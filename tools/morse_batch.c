@@ -0,0 +1,674 @@
+// Host batch converter built from the app's core code.
+//
+//   morse_batch encode <in_dir> <out_dir> [options]   .txt -> .wav, .sub, .fmf
+//   morse_batch decode <in_dir> <out_dir> [options]   .wav, .sub, .mkt -> .txt
+//
+// Options:
+//   -j <n>          worker threads (default: online CPUs)
+//   -w <wpm>        keying speed, or the decoder's starting estimate (default 20)
+//   -t <hz>         tone frequency (default 800)
+//   -r <hz>         WAV sample rate for encoding (default 8000)
+//   -f <list>       output formats for encoding, comma separated (default wav,sub,fmf)
+//   -g <percent>    encoding: add a spike, dropout or contact bounce to that share of runs
+//   -p <percent>    decoding: glitch filter minimum in percent of a dot (default 35)
+//   --no-filter     decoding: feed the decoder every run, same as -p 0
+//   -a <dir>        decoding: score against <dir>/<name>.txt and report accuracy
+//
+// Every file is one task for the worker pool; throughput is reported at the end.
+// Glitches are seeded from the file name, so a corpus is reproducible.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <time.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "morse_core.h"
+#include "wav.h"
+
+#define DEFAULT_WPM 20
+#define DEFAULT_TONE_HZ 800
+#define DEFAULT_RATE_HZ 8000
+#define RAMP_MS 5                  // Raised-cosine key edges, no clicks
+#define AMPLITUDE 16000
+#define SUB_VALUES_PER_LINE 512    // As written by the SubGHz app
+#define ENVELOPE_BLOCK_MS 5        // Tone detector resolution when decoding WAV
+#define PATH_LENGTH 1024
+#define GLITCH_MIN_US 2000         // Injected glitch length, 2 to 8 ms
+#define GLITCH_SPAN_US 6000
+#define SCORE_BAND 256             // Alignment drift the accuracy score follows
+
+typedef enum {
+    ModeEncode,
+    ModeDecode
+} BatchMode;
+
+typedef struct {
+    BatchMode mode;
+    const char* out_dir;
+    int wpm;
+    int tone_hz;
+    uint32_t rate;
+    bool wav;
+    bool sub;
+    bool fmf;
+    int glitch_percent;
+    int filter_percent;
+    const char* reference_dir;
+
+    char** files;
+    size_t file_count;
+    size_t next_file;              // Shared task index, taken atomically
+
+    // Totals, updated atomically by the workers
+    size_t done;
+    size_t failed;
+    uint64_t samples;
+    uint64_t suppressed;           // Glitches the filter merged away
+    size_t scored;                 // Files with a reference text
+    uint64_t reference_characters;
+    uint64_t errors;               // Edit distance to the references
+} Batch;
+
+// Growable buffers
+typedef struct {
+    int8_t* data;
+    size_t count;
+    size_t capacity;
+} UnitBuffer;
+
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} TextBuffer;
+
+// Signed microseconds, marks positive
+typedef struct {
+    int32_t* data;
+    size_t count;
+    size_t capacity;
+} TimingBuffer;
+
+static void units_push(UnitBuffer* buffer, int8_t units) {
+    if(buffer->count == buffer->capacity) {
+        buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 1024;
+        buffer->data = realloc(buffer->data, buffer->capacity);
+    }
+    buffer->data[buffer->count++] = units;
+}
+
+static void timing_push(TimingBuffer* buffer, int32_t duration_us) {
+    if(buffer->count == buffer->capacity) {
+        buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 1024;
+        buffer->data = realloc(buffer->data, buffer->capacity * sizeof(int32_t));
+    }
+    buffer->data[buffer->count++] = duration_us;
+}
+
+static void text_push(TextBuffer* buffer, char c) {
+    if(buffer->length + 1 >= buffer->capacity) {
+        buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 256;
+        buffer->data = realloc(buffer->data, buffer->capacity);
+    }
+    buffer->data[buffer->length++] = c;
+    buffer->data[buffer->length] = '\0';
+}
+
+static char* read_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if(!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* data = malloc(length + 1);
+    *size = fread(data, 1, length, file);
+    data[*size] = '\0';
+    fclose(file);
+    return data;
+}
+
+// dir/<input name without extension><extension>
+static void sibling_path(char* out, const char* dir, const char* input, const char* extension) {
+    const char* name = strrchr(input, '/');
+    name = name ? name + 1 : input;
+    const char* dot = strrchr(name, '.');
+    int length = dot ? (int)(dot - name) : (int)strlen(name);
+    snprintf(out, PATH_LENGTH, "%s/%.*s%s", dir, length, name, extension);
+}
+
+static void output_path(char* out, const Batch* batch, const char* input, const char* extension) {
+    sibling_path(out, batch->out_dir, input, extension);
+}
+
+// FNV-1a of the file name, the glitch seed
+static uint32_t name_seed(const char* input) {
+    const char* name = strrchr(input, '/');
+    uint32_t hash = 2166136261u;
+    for(const char* c = name ? name + 1 : input; *c; c++) hash = (hash ^ (uint8_t)*c) * 16777619u;
+    return hash;
+}
+
+static bool has_extension(const char* path, const char* extension) {
+    size_t path_length = strlen(path);
+    size_t extension_length = strlen(extension);
+    return path_length > extension_length && strcasecmp(path + path_length - extension_length, extension) == 0;
+}
+
+// Text to dot units, one character at a time through the app encoder
+static void encode_text(const char* text, UnitBuffer* units) {
+    MorseSchedule schedule;
+    for(size_t i = 0; text[i] != '\0'; i++) {
+        if(isspace((unsigned char)text[i])) {
+            // Widen the letter gap before it to a word gap
+            if(units->count > 0) units->data[units->count - 1] = -7;
+            continue;
+        }
+        char single[2] = {text[i], '\0'};
+        encode_units(&schedule, single);
+        for(uint16_t j = 0; j < schedule.count; j++) {
+            units_push(units, (int8_t)schedule.elements[j]);
+        }
+    }
+}
+
+// Key timing with edges at rounded multiples of the exact unit. With -g, that
+// share of runs gets a glitch: a mark bounces as it opens or drops out in the
+// middle, a space picks up a noise spike.
+static void units_to_timing(const Batch* batch, const UnitBuffer* units, TimingBuffer* timing, MorseRng* rng) {
+    double unit_us = 1200000.0 / batch->wpm;
+    uint64_t position = 0;
+    long long edge_us = 0;
+    for(size_t i = 0; i < units->count; i++) {
+        position += abs(units->data[i]);
+        long long next_edge_us = llround(position * unit_us);
+        int32_t duration = (int32_t)(next_edge_us - edge_us);
+        int32_t sign = (units->data[i] > 0) ? 1 : -1;
+        edge_us = next_edge_us;
+
+        if(batch->glitch_percent > 0 && (int)morse_rng_range(rng, 100) < batch->glitch_percent) {
+            int32_t glitch = GLITCH_MIN_US + (int32_t)morse_rng_range(rng, GLITCH_SPAN_US);
+            if(duration > 3 * glitch) {
+                int32_t before = (sign > 0 && morse_rng_range(rng, 2)) ? glitch : (duration - glitch) / 2;
+                timing_push(timing, sign * before);
+                timing_push(timing, -sign * glitch);
+                timing_push(timing, sign * (duration - before - glitch));
+                continue;
+            }
+        }
+        timing_push(timing, sign * duration);
+    }
+}
+
+// Keyed sine tone following the timing
+static bool write_wav(const Batch* batch, const char* path, const TimingBuffer* timing, uint64_t* sample_count) {
+    uint64_t total_us = 0;
+    for(size_t i = 0; i < timing->count; i++) total_us += abs(timing->data[i]);
+    size_t count = (size_t)llround(total_us * (double)batch->rate / 1e6);
+    int16_t* samples = calloc(count + 1, sizeof(int16_t));
+    double step = 2.0 * M_PI * batch->tone_hz / batch->rate;
+    size_t ramp = batch->rate * RAMP_MS / 1000;
+
+    uint64_t position_us = 0;
+    for(size_t i = 0; i < timing->count; i++) {
+        int32_t element = timing->data[i];
+        size_t start = (size_t)llround(position_us * (double)batch->rate / 1e6);
+        position_us += abs(element);
+        size_t end = (size_t)llround(position_us * (double)batch->rate / 1e6);
+        if(element < 0) continue;
+
+        size_t length = end - start;
+        size_t edge = (ramp * 2 < length) ? ramp : length / 2;
+        for(size_t n = 0; n < length && start + n < count; n++) {
+            double gain = 1.0;
+            if(n < edge) gain = 0.5 - 0.5 * cos(M_PI * n / edge);
+            if(length - n <= edge) gain = 0.5 - 0.5 * cos(M_PI * (length - n) / edge);
+            samples[start + n] = (int16_t)(AMPLITUDE * gain * sin(step * (start + n)));
+        }
+    }
+
+    bool ok = wav_write_mono(path, samples, count, batch->rate);
+    free(samples);
+    *sample_count = count;
+    return ok;
+}
+
+// SubGHz RAW file, durations in microseconds with marks positive
+static bool write_sub(const char* path, const TimingBuffer* timing) {
+    FILE* file = fopen(path, "w");
+    if(!file) return false;
+
+    fprintf(file, "Filetype: Flipper SubGhz RAW File\nVersion: 1\nFrequency: 433920000\n");
+    fprintf(file, "Preset: FuriHalSubGhzPresetOok650Async\nProtocol: RAW\n");
+
+    for(size_t i = 0; i < timing->count; i++) {
+        if(i % SUB_VALUES_PER_LINE == 0) fprintf(file, i ? "\nRAW_Data:" : "RAW_Data:");
+        fprintf(file, " %ld", (long)timing->data[i]);
+    }
+    fprintf(file, "\n");
+    return fclose(file) == 0;
+}
+
+// Note name for a frequency, equal temperament around A4 = 440 Hz
+static void note_name(int frequency, char* name, size_t size) {
+    static const char* const NAMES[12] = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+    int semitone = (int)lround(12.0 * log2(frequency / 440.0)) + 57;  // From C0
+    if(semitone < 0) semitone = 0;
+    snprintf(name, size, "%s%d", NAMES[semitone % 12], semitone / 12);
+}
+
+// Flipper Music Format: one unit is a sixteenth note, so BPM = 12.5 * WPM
+static bool write_fmf(const Batch* batch, const char* path, const UnitBuffer* units) {
+    FILE* file = fopen(path, "w");
+    if(!file) return false;
+
+    char note[12];
+    note_name(batch->tone_hz, note, sizeof(note));
+    fprintf(file, "Filetype: Flipper Music Format\nVersion: 0\nBPM: %d\nDuration: 16\nOctave: 5\nNotes: ",
+        (int)lround(12.5 * batch->wpm));
+
+    for(size_t i = 0; i < units->count; i++) {
+        int8_t element = units->data[i];
+        const char* name = (element > 0) ? note : "P";
+        const char* separator = i ? ", " : "";
+        switch(abs(element)) {
+            case 1: fprintf(file, "%s16%s", separator, name); break;
+            case 3: fprintf(file, "%s8%s.", separator, name); break;
+            default: fprintf(file, "%s4%s..", separator, name); break;
+        }
+    }
+    fprintf(file, "\n");
+    return fclose(file) == 0;
+}
+
+static bool encode_file(Batch* batch, const char* input, uint64_t* samples) {
+    size_t size;
+    char* text = read_file(input, &size);
+    if(!text) return false;
+
+    UnitBuffer units = {0};
+    encode_text(text, &units);
+    free(text);
+
+    TimingBuffer timing = {0};
+    MorseRng rng;
+    morse_rng_seed(&rng, name_seed(input));
+    units_to_timing(batch, &units, &timing, &rng);
+
+    char path[PATH_LENGTH];
+    bool ok = true;
+    *samples = 0;
+    if(batch->wav) {
+        output_path(path, batch, input, ".wav");
+        ok = write_wav(batch, path, &timing, samples) && ok;
+    }
+    if(batch->sub) {
+        output_path(path, batch, input, ".sub");
+        ok = write_sub(path, &timing) && ok;
+    }
+    if(batch->fmf) {
+        output_path(path, batch, input, ".fmf");
+        ok = write_fmf(batch, path, &units) && ok;
+    }
+
+    free(units.data);
+    free(timing.data);
+    return ok;
+}
+
+static void decoded_callback(char character, void* context) {
+    text_push(context, character);
+}
+
+static int compare_float(const void* a, const void* b) {
+    float x = *(const float*)a;
+    float y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+// Goertzel tone power per block, thresholded halfway between the noise floor
+// and the signal level with hysteresis, then decoded from the run lengths
+static void decode_wav_samples(
+    const Batch* batch, const int16_t* samples, size_t count, uint32_t rate, MorseGlitchFilter* filter) {
+    size_t block = rate * ENVELOPE_BLOCK_MS / 1000;
+    size_t blocks = count / block;
+    if(blocks == 0) return;
+
+    float* level = malloc(blocks * sizeof(float));
+    double coefficient = 2.0 * cos(2.0 * M_PI * batch->tone_hz / rate);
+    for(size_t b = 0; b < blocks; b++) {
+        double s1 = 0, s2 = 0;
+        for(size_t n = 0; n < block; n++) {
+            double s0 = samples[b * block + n] + coefficient * s1 - s2;
+            s2 = s1;
+            s1 = s0;
+        }
+        level[b] = (float)sqrt(s1 * s1 + s2 * s2 - coefficient * s1 * s2);
+    }
+
+    float* sorted = malloc(blocks * sizeof(float));
+    memcpy(sorted, level, blocks * sizeof(float));
+    qsort(sorted, blocks, sizeof(float), compare_float);
+    float noise = sorted[blocks / 5];
+    float signal = sorted[blocks - 1 - blocks / 20];
+    free(sorted);
+    float on_threshold = noise + 0.6f * (signal - noise);
+    float off_threshold = noise + 0.4f * (signal - noise);
+
+    uint32_t block_us = (uint32_t)(1000000ull * block / rate);
+    bool key_down = false;
+    bool started = false;
+    uint32_t run = 0;
+    for(size_t b = 0; b < blocks; b++) {
+        bool state = key_down ? level[b] > off_threshold : level[b] > on_threshold;
+        if(state != key_down) {
+            if(started) morse_filter_run(filter, key_down, run * block_us);
+            started = true;
+            key_down = state;
+            run = 0;
+        }
+        run++;
+    }
+    if(started && key_down) morse_filter_run(filter, true, run * block_us);
+    free(level);
+}
+
+// Values of "RAW_Data:" or "Timing:" lines, signed microseconds
+static size_t decode_timing_text(char* text, MorseGlitchFilter* filter) {
+    size_t values = 0;
+    for(char* line = strtok(text, "\n"); line; line = strtok(NULL, "\n")) {
+        char* data = NULL;
+        if(strncmp(line, "RAW_Data:", 9) == 0) data = line + 9;
+        if(strncmp(line, "Timing:", 7) == 0) data = line + 7;
+        if(!data) continue;
+
+        char* end;
+        for(long value = strtol(data, &end, 10); end != data; value = strtol(data, &end, 10)) {
+            morse_filter_run(filter, value > 0, (uint32_t)labs(value));
+            data = end;
+            values++;
+        }
+    }
+    return values;
+}
+
+// Uppercase table characters with single spaces, as the decoder writes them
+static size_t normalise_text(char* text) {
+    size_t length = 0;
+    bool space = true;
+    for(const char* c = text; *c; c++) {
+        if(isspace((unsigned char)*c)) {
+            if(!space) text[length++] = ' ';
+            space = true;
+        } else if(get_morse_for_char(*c)) {
+            text[length++] = (char)toupper((unsigned char)*c);
+            space = false;
+        }
+    }
+    while(length > 0 && text[length - 1] == ' ') length--;
+    text[length] = '\0';
+    return length;
+}
+
+// Character edit distance within SCORE_BAND of the diagonal; drift beyond it
+// counts as errors, which keeps long files linear
+static uint64_t edit_distance(const char* a, size_t a_length, const char* b, size_t b_length) {
+    const uint64_t far = UINT64_MAX / 2;
+    uint64_t* previous = malloc((b_length + 1) * sizeof(uint64_t));
+    uint64_t* current = malloc((b_length + 1) * sizeof(uint64_t));
+    for(size_t j = 0; j <= b_length; j++) previous[j] = (j <= SCORE_BAND) ? j : far;
+
+    for(size_t i = 1; i <= a_length; i++) {
+        size_t low = (i > SCORE_BAND) ? i - SCORE_BAND : 0;
+        size_t high = (i + SCORE_BAND < b_length) ? i + SCORE_BAND : b_length;
+        if(low > 0) current[low - 1] = far;
+        current[low] = (low == 0) ? i : far;
+        if(high < b_length) current[high + 1] = far;
+        for(size_t j = (low > 0 ? low : 1); j <= high; j++) {
+            uint64_t best = previous[j - 1] + (a[i - 1] != b[j - 1]);
+            if(previous[j] + 1 < best) best = previous[j] + 1;
+            if(current[j - 1] + 1 < best) best = current[j - 1] + 1;
+            current[j] = best;
+        }
+        uint64_t* swap = previous;
+        previous = current;
+        current = swap;
+    }
+
+    uint64_t distance = previous[b_length];
+    if(distance >= far) distance = (a_length > b_length) ? a_length : b_length;
+    free(previous);
+    free(current);
+    return distance;
+}
+
+static void score_file(Batch* batch, const char* input, const char* decoded) {
+    char path[PATH_LENGTH];
+    sibling_path(path, batch->reference_dir, input, ".txt");
+    size_t size;
+    char* reference = read_file(path, &size);
+    if(!reference) return;
+
+    size_t reference_length = normalise_text(reference);
+    uint64_t errors = edit_distance(decoded, strlen(decoded), reference, reference_length);
+    __atomic_fetch_add(&batch->scored, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&batch->reference_characters, reference_length, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&batch->errors, errors, __ATOMIC_RELAXED);
+    free(reference);
+}
+
+static bool decode_file(Batch* batch, const char* input, uint64_t* samples) {
+    TextBuffer text = {0};
+    MorseDecoder decoder;
+    MorseGlitchFilter filter;
+    morse_decoder_init(&decoder, (uint8_t)batch->wpm, decoded_callback, &text);
+    morse_filter_init(&filter, &decoder, (uint8_t)batch->filter_percent);
+    text_push(&text, '\0');
+    text.length = 0;
+
+    if(has_extension(input, ".wav")) {
+        int16_t* audio;
+        size_t count;
+        uint32_t rate;
+        if(!wav_read_mono(input, &audio, &count, &rate)) {
+            free(text.data);
+            return false;
+        }
+        decode_wav_samples(batch, audio, count, rate, &filter);
+        free(audio);
+        *samples = count;
+    } else {
+        size_t size;
+        char* data = read_file(input, &size);
+        if(!data) {
+            free(text.data);
+            return false;
+        }
+        *samples = decode_timing_text(data, &filter);
+        free(data);
+    }
+    morse_filter_flush(&filter);
+    morse_decoder_flush(&decoder);
+    while(text.length > 0 && text.data[text.length - 1] == ' ') text.data[--text.length] = '\0';
+    __atomic_fetch_add(&batch->suppressed, filter.suppressed, __ATOMIC_RELAXED);
+    if(batch->reference_dir) score_file(batch, input, text.data);
+
+    char path[PATH_LENGTH];
+    output_path(path, batch, input, ".txt");
+    FILE* out = fopen(path, "w");
+    bool ok = out && fprintf(out, "%s\n", text.data) >= 0;
+    if(out) ok = (fclose(out) == 0) && ok;
+    free(text.data);
+    return ok;
+}
+
+static void* worker(void* context) {
+    Batch* batch = context;
+
+    for(;;) {
+        size_t index = __atomic_fetch_add(&batch->next_file, 1, __ATOMIC_RELAXED);
+        if(index >= batch->file_count) break;
+
+        uint64_t samples = 0;
+        const char* input = batch->files[index];
+        bool ok = (batch->mode == ModeEncode) ? encode_file(batch, input, &samples) :
+                                                decode_file(batch, input, &samples);
+        if(!ok) {
+            fprintf(stderr, "%s: failed\n", input);
+            __atomic_fetch_add(&batch->failed, 1, __ATOMIC_RELAXED);
+        }
+        __atomic_fetch_add(&batch->done, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&batch->samples, samples, __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+static bool wanted_input(const Batch* batch, const char* name) {
+    if(batch->mode == ModeEncode) return has_extension(name, ".txt");
+    return has_extension(name, ".wav") || has_extension(name, ".sub") || has_extension(name, ".mkt");
+}
+
+static int compare_strings(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static bool list_inputs(Batch* batch, const char* in_dir) {
+    DIR* dir = opendir(in_dir);
+    if(!dir) return false;
+
+    size_t capacity = 0;
+    struct dirent* entry;
+    while((entry = readdir(dir))) {
+        if(entry->d_name[0] == '.' || !wanted_input(batch, entry->d_name)) continue;
+        if(batch->file_count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            batch->files = realloc(batch->files, capacity * sizeof(char*));
+        }
+        char* path = malloc(PATH_LENGTH);
+        snprintf(path, PATH_LENGTH, "%s/%s", in_dir, entry->d_name);
+        batch->files[batch->file_count++] = path;
+    }
+    closedir(dir);
+
+    if(batch->file_count) qsort(batch->files, batch->file_count, sizeof(char*), compare_strings);
+    return true;
+}
+
+static void usage(const char* name) {
+    fprintf(stderr,
+        "usage: %s encode|decode <in_dir> <out_dir> [-j threads] [-w wpm] [-t tone_hz] [-r rate] [-f wav,sub,fmf]\n"
+        "       [-g glitch_percent] [-p filter_percent] [--no-filter] [-a reference_dir]\n",
+        name);
+}
+
+int main(int argc, char** argv) {
+    if(argc < 4) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    Batch batch = {
+        .wpm = DEFAULT_WPM,
+        .tone_hz = DEFAULT_TONE_HZ,
+        .rate = DEFAULT_RATE_HZ,
+        .wav = true,
+        .sub = true,
+        .fmf = true,
+        .filter_percent = GLITCH_DEFAULT_PERCENT,
+        .out_dir = argv[3],
+    };
+    if(strcmp(argv[1], "encode") == 0) {
+        batch.mode = ModeEncode;
+    } else if(strcmp(argv[1], "decode") == 0) {
+        batch.mode = ModeDecode;
+    } else {
+        usage(argv[0]);
+        return 2;
+    }
+
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    for(int i = 4; i < argc; i++) {
+        if(strcmp(argv[i], "--no-filter") == 0) {
+            batch.filter_percent = 0;
+            continue;
+        }
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if(!value) {
+            usage(argv[0]);
+            return 2;
+        }
+        if(strcmp(argv[i], "-j") == 0) {
+            threads = atoi(value);
+        } else if(strcmp(argv[i], "-w") == 0) {
+            batch.wpm = atoi(value);
+        } else if(strcmp(argv[i], "-t") == 0) {
+            batch.tone_hz = atoi(value);
+        } else if(strcmp(argv[i], "-r") == 0) {
+            batch.rate = (uint32_t)atoi(value);
+        } else if(strcmp(argv[i], "-f") == 0) {
+            batch.wav = strstr(value, "wav") != NULL;
+            batch.sub = strstr(value, "sub") != NULL;
+            batch.fmf = strstr(value, "fmf") != NULL;
+        } else if(strcmp(argv[i], "-g") == 0) {
+            batch.glitch_percent = atoi(value);
+        } else if(strcmp(argv[i], "-p") == 0) {
+            batch.filter_percent = atoi(value);
+        } else if(strcmp(argv[i], "-a") == 0) {
+            batch.reference_dir = value;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+    if(threads < 1) threads = 1;
+    if(batch.wpm < MIN_WPM || batch.wpm > MAX_WPM) {
+        fprintf(stderr, "speed must be %d-%d WPM\n", MIN_WPM, MAX_WPM);
+        return 2;
+    }
+    if(batch.glitch_percent < 0 || batch.glitch_percent > 100 || batch.filter_percent < 0 ||
+       batch.filter_percent > 100) {
+        fprintf(stderr, "percentages must be 0-100\n");
+        return 2;
+    }
+
+    if(!list_inputs(&batch, argv[2])) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    pthread_t* pool = malloc(threads * sizeof(pthread_t));
+    for(int i = 0; i < threads; i++) pthread_create(&pool[i], NULL, worker, &batch);
+    for(int i = 0; i < threads; i++) pthread_join(pool[i], NULL);
+    free(pool);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    if(seconds <= 0) seconds = 1e-9;
+
+    printf("%zu files (%zu failed) in %.3f s on %d threads: %.1f files/s, %.0f samples/s\n",
+        batch.done, batch.failed, seconds, threads, batch.done / seconds, batch.samples / seconds);
+    if(batch.mode == ModeDecode) {
+        printf("glitch filter %s: %llu glitches suppressed\n", batch.filter_percent ? "on" : "off",
+            (unsigned long long)batch.suppressed);
+    }
+    if(batch.scored > 0) {
+        double accuracy = batch.reference_characters ?
+                              100.0 * (1.0 - (double)batch.errors / batch.reference_characters) :
+                              100.0;
+        printf("accuracy %.2f%%: %llu errors in %llu characters of %zu reference texts\n", accuracy,
+            (unsigned long long)batch.errors, (unsigned long long)batch.reference_characters, batch.scored);
+    }
+
+    for(size_t i = 0; i < batch.file_count; i++) free(batch.files[i]);
+    free(batch.files);
+    return batch.failed ? 1 : 0;
+}
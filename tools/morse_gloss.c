@@ -0,0 +1,208 @@
+// Host-side glossary generator: turns gloss.txt into ../morse_gloss_table.h,
+// a minimal perfect hash the app looks words up in without probing. Build
+// with `make` and regenerate with `make gloss` in this directory.
+//
+// Source format, '#' starts a comment:
+//   <WORD> <meaning>    word as decoded, meaning up to GLOSS_MEANING_MAX
+//
+// Hash and displace: words are grouped into buckets by one hash, then the
+// fullest buckets go first, each trying seeds until all of its words land on
+// free slots. The table has exactly one slot per word.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "morse_core.h"
+#include "morse_gloss.h"
+
+#define MAX_ENTRIES 1024
+#define WORD_MAX 12
+#define SEED_MAX 0xFFFF            // Seeds are stored as uint16_t
+
+typedef struct {
+    char word[WORD_MAX + 1];
+    char meaning[GLOSS_MEANING_MAX + 1];
+} Entry;
+
+typedef struct {
+    uint16_t members[MAX_ENTRIES];
+    uint16_t count;
+    uint16_t bucket;
+} Bucket;
+
+static Entry entries[MAX_ENTRIES];
+static size_t entry_count;
+
+static int compare_buckets(const void* a, const void* b) {
+    const Bucket* left = *(const Bucket* const*)a;
+    const Bucket* right = *(const Bucket* const*)b;
+    if(left->count != right->count) return (int)right->count - (int)left->count;
+    return (int)left->bucket - (int)right->bucket;
+}
+
+static bool parse(FILE* input) {
+    char line[256];
+    int line_number = 0;
+    while(fgets(line, sizeof(line), input)) {
+        line_number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        char* text = line + strspn(line, " \t");
+        if(*text == '#' || *text == '\0') continue;
+
+        size_t word_length = strcspn(text, " \t");
+        char* meaning = text + word_length;
+        meaning += strspn(meaning, " \t");
+        size_t meaning_length = strlen(meaning);
+        while(meaning_length > 0 && isspace((unsigned char)meaning[meaning_length - 1])) meaning_length--;
+
+        if(word_length > WORD_MAX || meaning_length == 0 || meaning_length > GLOSS_MEANING_MAX) {
+            fprintf(stderr, "line %d: word up to %d and meaning of 1-%d characters\n", line_number, WORD_MAX,
+                GLOSS_MEANING_MAX);
+            return false;
+        }
+        for(size_t i = 0; i < word_length; i++) {
+            if(islower((unsigned char)text[i]) || get_table_index_for_char(text[i]) < 0) {
+                fprintf(stderr, "line %d: '%c' is never decoded\n", line_number, text[i]);
+                return false;
+            }
+        }
+        if(entry_count == MAX_ENTRIES) {
+            fprintf(stderr, "more than %d words\n", MAX_ENTRIES);
+            return false;
+        }
+
+        Entry* entry = &entries[entry_count];
+        memcpy(entry->word, text, word_length);
+        entry->word[word_length] = '\0';
+        memcpy(entry->meaning, meaning, meaning_length);
+        entry->meaning[meaning_length] = '\0';
+        for(size_t i = 0; i < entry_count; i++) {
+            if(strcmp(entries[i].word, entry->word) == 0) {
+                fprintf(stderr, "line %d: %s is listed twice\n", line_number, entry->word);
+                return false;
+            }
+        }
+        entry_count++;
+    }
+    return entry_count > 0;
+}
+
+// Seeds for bucket_count buckets, or false if some bucket found no seed
+static bool place(size_t bucket_count, uint16_t* seeds, int16_t* slots) {
+    Bucket* buckets = calloc(bucket_count, sizeof(Bucket));
+    Bucket** order = malloc(bucket_count * sizeof(Bucket*));
+    for(size_t b = 0; b < bucket_count; b++) {
+        buckets[b].bucket = (uint16_t)b;
+        order[b] = &buckets[b];
+    }
+    for(size_t i = 0; i < entry_count; i++) {
+        const char* word = entries[i].word;
+        Bucket* bucket = &buckets[morse_gloss_hash(word, strlen(word), 0) % bucket_count];
+        bucket->members[bucket->count++] = (uint16_t)i;
+    }
+    qsort(order, bucket_count, sizeof(Bucket*), compare_buckets);
+
+    for(size_t i = 0; i < entry_count; i++) slots[i] = -1;
+    bool ok = true;
+    for(size_t b = 0; b < bucket_count && ok; b++) {
+        const Bucket* bucket = order[b];
+        seeds[bucket->bucket] = 0;
+        if(bucket->count == 0) continue;
+
+        ok = false;
+        for(uint32_t seed = 1; seed <= SEED_MAX && !ok; seed++) {
+            size_t placed = 0;
+            for(; placed < bucket->count; placed++) {
+                const char* word = entries[bucket->members[placed]].word;
+                size_t slot = morse_gloss_hash(word, strlen(word), seed) % entry_count;
+                if(slots[slot] >= 0) break;
+                slots[slot] = (int16_t)bucket->members[placed];
+            }
+            if(placed == bucket->count) {
+                seeds[bucket->bucket] = (uint16_t)seed;
+                ok = true;
+                break;
+            }
+            // Take back this seed's words before the next one
+            for(size_t i = 0; i < placed; i++) {
+                const char* word = entries[bucket->members[i]].word;
+                slots[morse_gloss_hash(word, strlen(word), seed) % entry_count] = -1;
+            }
+        }
+    }
+
+    free(order);
+    free(buckets);
+    return ok;
+}
+
+static void print_string(const char* text) {
+    putchar('"');
+    for(; *text; text++) {
+        if(*text == '"' || *text == '\\') putchar('\\');
+        putchar(*text);
+    }
+    putchar('"');
+}
+
+int main(int argc, char** argv) {
+    if(argc != 2) {
+        fprintf(stderr, "usage: morse_gloss gloss.txt > ../morse_gloss_table.h\n");
+        return 2;
+    }
+    FILE* input = fopen(argv[1], "r");
+    if(!input) {
+        perror(argv[1]);
+        return 1;
+    }
+    bool ok = parse(input);
+    fclose(input);
+    if(!ok) return 1;
+
+    // Fewest buckets that place, about four words each to start with
+    uint16_t seeds[MAX_ENTRIES];
+    int16_t slots[MAX_ENTRIES];
+    size_t bucket_count = (entry_count + 3) / 4;
+    while(!place(bucket_count, seeds, slots)) bucket_count++;
+
+    size_t word_max = 0;
+    for(size_t i = 0; i < entry_count; i++) {
+        size_t length = strlen(entries[i].word);
+        if(length > word_max) word_max = length;
+
+        // Check every word the way the app will look it up
+        const char* word = entries[i].word;
+        uint32_t seed = seeds[morse_gloss_hash(word, length, 0) % bucket_count];
+        if(slots[morse_gloss_hash(word, length, seed) % entry_count] != (int16_t)i) {
+            fprintf(stderr, "%s is not where the lookup expects it\n", word);
+            return 1;
+        }
+    }
+
+    printf("#pragma once\n\n");
+    printf("// Generated by tools/morse_gloss from tools/gloss.txt; edit that and run\n");
+    printf("// `make gloss` in tools/. Included by morse_gloss.c only.\n\n");
+    printf("#define GLOSS_COUNT %zu\n", entry_count);
+    printf("#define GLOSS_BUCKETS %zu\n", bucket_count);
+    printf("#define GLOSS_WORD_MAX %zu\n\n", word_max);
+
+    printf("static const uint16_t GLOSS_SEEDS[GLOSS_BUCKETS] = {");
+    for(size_t b = 0; b < bucket_count; b++) printf("%s%u,", (b % 12) ? " " : "\n    ", seeds[b]);
+    printf("\n};\n\n");
+
+    printf("static const MorseGloss GLOSS_TABLE[GLOSS_COUNT] = {\n");
+    for(size_t i = 0; i < entry_count; i++) {
+        const Entry* entry = &entries[slots[i]];
+        printf("    {");
+        print_string(entry->word);
+        printf(", ");
+        print_string(entry->meaning);
+        printf("},\n");
+    }
+    printf("};\n");
+
+    fprintf(stderr, "%zu words in %zu buckets\n", entry_count, bucket_count);
+    return 0;
+}
@@ -0,0 +1,214 @@
+// Host-side lesson packer: compiles a lesson source text into a binary .mlp
+// pack for the Lessons mode. Build with `make` in this directory. The pack is
+// written in host byte order, which matches the device on little-endian hosts.
+//
+// Source format, one directive per line, '#' starts a comment:
+//   lesson <title>      starts a new lesson
+//   chars <CHARS>       characters the lesson introduces
+//   wpm <n>             target speed
+//   pass <n>            copy accuracy in percent needed to pass
+//   drill <text>        drill text, repeatable
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "morse_core.h"
+
+#define MAX_LESSONS 256
+#define MAX_DRILLS 64
+#define MAX_ELEMENTS (LESSON_TEXT_MAX * 16)
+
+typedef struct {
+    char text[LESSON_TEXT_MAX + 1];
+    int8_t elements[MAX_ELEMENTS];
+    uint16_t element_count;
+} Drill;
+
+typedef struct {
+    char title[LESSON_TITLE_MAX + 1];
+    LessonHeader header;
+    Drill* drills;
+} Lesson;
+
+// Encode drill text in dot units, reusing the app encoder one character at a time
+static bool encode_drill(Drill* drill, int line_number) {
+    MorseSchedule schedule;
+    drill->element_count = 0;
+
+    for(size_t i = 0; drill->text[i] != '\0'; i++) {
+        char c = toupper((unsigned char)drill->text[i]);
+        drill->text[i] = c;
+
+        if(c == ' ') {
+            // Widen the letter gap before it to a word gap
+            if(drill->element_count > 0) drill->elements[drill->element_count - 1] = -7;
+            continue;
+        }
+
+        char single[2] = {c, '\0'};
+        encode_units(&schedule, single);
+        if(schedule.count == 0) {
+            fprintf(stderr, "line %d: '%c' has no Morse code\n", line_number, c);
+            return false;
+        }
+        for(uint16_t j = 0; j < schedule.count; j++) {
+            drill->elements[drill->element_count++] = (int8_t)schedule.elements[j];
+        }
+    }
+
+    return true;
+}
+
+// Drop the trailing newline and surrounding spaces
+static char* trim(char* line) {
+    while(isspace((unsigned char)*line)) line++;
+    size_t length = strlen(line);
+    while(length > 0 && isspace((unsigned char)line[length - 1])) line[--length] = '\0';
+    return line;
+}
+
+static bool parse_source(FILE* source, Lesson* lessons, int* lesson_count) {
+    char buffer[256];
+    int line_number = 0;
+    Lesson* lesson = NULL;
+
+    while(fgets(buffer, sizeof(buffer), source)) {
+        line_number++;
+        char* line = trim(buffer);
+        if(line[0] == '\0' || line[0] == '#') continue;
+
+        char* value = line;
+        while(*value && !isspace((unsigned char)*value)) value++;
+        if(*value) *value++ = '\0';
+        value = trim(value);
+
+        if(strcmp(line, "lesson") == 0) {
+            if(*lesson_count == MAX_LESSONS) {
+                fprintf(stderr, "line %d: more than %d lessons\n", line_number, MAX_LESSONS);
+                return false;
+            }
+            lesson = &lessons[(*lesson_count)++];
+            memset(lesson, 0, sizeof(Lesson));
+            lesson->drills = calloc(MAX_DRILLS, sizeof(Drill));
+            strncpy(lesson->title, value, LESSON_TITLE_MAX);
+            lesson->header.target_wpm = 15;
+            lesson->header.pass_percent = 90;
+            continue;
+        }
+
+        if(!lesson) {
+            fprintf(stderr, "line %d: '%s' before the first lesson\n", line_number, line);
+            return false;
+        }
+
+        if(strcmp(line, "chars") == 0) {
+            for(size_t i = 0; i < LESSON_CHARS_MAX && value[i]; i++) {
+                lesson->header.new_chars[i] = toupper((unsigned char)value[i]);
+            }
+        } else if(strcmp(line, "wpm") == 0) {
+            int wpm = atoi(value);
+            if(wpm < MIN_WPM || wpm > MAX_WPM) {
+                fprintf(stderr, "line %d: speed must be %d-%d WPM\n", line_number, MIN_WPM, MAX_WPM);
+                return false;
+            }
+            lesson->header.target_wpm = (uint8_t)wpm;
+        } else if(strcmp(line, "pass") == 0) {
+            lesson->header.pass_percent = (uint8_t)atoi(value);
+        } else if(strcmp(line, "drill") == 0) {
+            if(lesson->header.drill_count == MAX_DRILLS) {
+                fprintf(stderr, "line %d: more than %d drills\n", line_number, MAX_DRILLS);
+                return false;
+            }
+            if(strlen(value) > LESSON_TEXT_MAX) {
+                fprintf(stderr, "line %d: drill longer than %d characters\n", line_number, LESSON_TEXT_MAX);
+                return false;
+            }
+            Drill* drill = &lesson->drills[lesson->header.drill_count++];
+            strcpy(drill->text, value);
+            if(!encode_drill(drill, line_number)) return false;
+        } else {
+            fprintf(stderr, "line %d: unknown directive '%s'\n", line_number, line);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static uint32_t lesson_size(const Lesson* lesson) {
+    uint32_t size = sizeof(LessonHeader);
+    for(int i = 0; i < lesson->header.drill_count; i++) {
+        size += sizeof(LessonDrillHeader) + strlen(lesson->drills[i].text) + lesson->drills[i].element_count;
+    }
+    return size;
+}
+
+static bool write_pack(FILE* out, const Lesson* lessons, int lesson_count) {
+    LessonPackHeader header = {.version = LESSON_PACK_VERSION, .lesson_count = (uint16_t)lesson_count};
+    memcpy(header.magic, LESSON_PACK_MAGIC, sizeof(header.magic));
+    fwrite(&header, sizeof(header), 1, out);
+
+    // Index first, so the device needs one seek per lesson
+    uint32_t offset = sizeof(LessonPackHeader) + lesson_count * sizeof(LessonIndexEntry);
+    for(int i = 0; i < lesson_count; i++) {
+        LessonIndexEntry entry = {.offset = offset, .size = lesson_size(&lessons[i])};
+        memcpy(entry.title, lessons[i].title, strnlen(lessons[i].title, LESSON_TITLE_MAX));
+        fwrite(&entry, sizeof(entry), 1, out);
+        offset += entry.size;
+    }
+
+    for(int i = 0; i < lesson_count; i++) {
+        const Lesson* lesson = &lessons[i];
+        fwrite(&lesson->header, sizeof(LessonHeader), 1, out);
+        for(int d = 0; d < lesson->header.drill_count; d++) {
+            const Drill* drill = &lesson->drills[d];
+            LessonDrillHeader drill_header = {
+                .text_length = (uint16_t)strlen(drill->text),
+                .element_count = drill->element_count,
+            };
+            fwrite(&drill_header, sizeof(drill_header), 1, out);
+            fwrite(drill->text, 1, drill_header.text_length, out);
+            fwrite(drill->elements, 1, drill->element_count, out);
+        }
+    }
+
+    return !ferror(out);
+}
+
+int main(int argc, char** argv) {
+    if(argc != 3) {
+        fprintf(stderr, "usage: %s <lessons.txt> <lessons.mlp>\n", argv[0]);
+        return 2;
+    }
+
+    FILE* source = fopen(argv[1], "r");
+    if(!source) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    static Lesson lessons[MAX_LESSONS];
+    int lesson_count = 0;
+    bool parsed = parse_source(source, lessons, &lesson_count);
+    fclose(source);
+    if(!parsed) return 1;
+
+    FILE* out = fopen(argv[2], "wb");
+    if(!out) {
+        perror(argv[2]);
+        return 1;
+    }
+    bool written = write_pack(out, lessons, lesson_count);
+    long size = ftell(out);
+    fclose(out);
+    if(!written) {
+        fprintf(stderr, "%s: write failed\n", argv[2]);
+        return 1;
+    }
+
+    printf("%d lessons, %ld bytes\n", lesson_count, size);
+    for(int i = 0; i < lesson_count; i++) free(lessons[i].drills);
+    return 0;
+}
@@ -0,0 +1,504 @@
+// Host CW skimmer: decodes every signal in a wideband recording at once.
+//
+//   morse_skimmer <recording.wav> [options]
+//
+// Options:
+//   -j <n>          worker threads (default: online CPUs)
+//   -l <hz>         lowest pitch to watch (default 200)
+//   -h <hz>         highest pitch to watch (default 2000)
+//   -w <wpm>        starting speed estimate of every decoder (default 20)
+//
+// The recording is cut into overlapping frames and split into narrow channels
+// by an FFT filter bank. Each channel keeps an envelope detector and one of the
+// app's adaptive decoders. Work is done a chunk of frames at a time in two
+// passes, both spread over the worker threads: the FFTs (frames are
+// independent) and then the channel update (channels are independent). Channel
+// state is kept as structure-of-arrays so the per-frame envelope update is a
+// plain loop over channels the compiler can vectorise.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "morse_core.h"
+#include "wav.h"
+
+#define DEFAULT_LOW_HZ 200
+#define DEFAULT_HIGH_HZ 2000
+#define DEFAULT_WPM 20
+#define CHANNEL_SPACING_HZ 64      // Filter bank bin width at most this
+#define HOP_MS 4                   // Timing resolution
+#define CHUNK_FRAMES 2500          // Frames per pass, 10 s at 4 ms
+#define NOISE_MS 1000              // Noise level average time constant
+#define NOISE_SEED_PERCENTILE 10   // First chunk level the starting noise is estimated from, below any keying
+#define NOISE_SEED_SCALE 2.73f     // Mean over 10th percentile of Rayleigh-distributed noise magnitudes
+#define NOISE_FLOOR_RATIO 0.001f   // Noise never below 60 dB under the strongest level, for clean audio
+#define PEAK_DECAY_MS 3000         // Signal level hold
+#define MIN_SNR 5.0f               // Peak over average noise, in magnitude, before a channel keys
+#define NEIGHBOUR_RATIO 0.5f       // Leakage from a stronger bin up to two away is ignored
+#define LINE_GAP_MS 2500           // Silence that ends a transcript line
+#define LINE_LENGTH 72
+#define MIN_LINE_CHARS 2           // Characters other than E and T, which noise produces most
+
+typedef struct {
+    double start_s;
+    double end_s;
+    float peak;
+    char text[LINE_LENGTH + 1];
+} Line;
+
+// Decoder side of a channel, touched only by the thread that owns the channel
+typedef struct {
+    MorseDecoder decoder;
+    bool key;
+    uint32_t run;                  // Frames since the last key edge
+    bool in_line;
+    double line_start_s;
+    float line_peak;
+    char text[LINE_LENGTH + 1];
+    size_t length;
+
+    Line* lines;
+    size_t line_count;
+    size_t line_capacity;
+} Channel;
+
+typedef enum {
+    PassSpectrum,
+    PassChannels
+} Pass;
+
+typedef struct {
+    const int16_t* samples;
+    size_t sample_count;
+    uint32_t rate;
+    size_t fft_size;
+    size_t hop;
+    uint32_t hop_us;
+    size_t first_bin;
+    size_t channel_count;
+    size_t frame_count;
+    int thread_count;
+
+    float* window;
+    float* twiddle_re;
+    float* twiddle_im;
+    size_t* bit_reverse;
+
+    // Current chunk: magnitudes, frame-major, one column per channel
+    size_t chunk_start;
+    size_t chunk_frames;
+    float* magnitude;
+
+    // Envelope state, structure-of-arrays over channels
+    float* noise;
+    float noise_floor;             // Shared by all channels, raised chunk by chunk
+    float* peak;
+    uint8_t* key;
+    uint8_t* detected;             // Last frame's raw detection
+    Channel* channels;
+
+    Pass pass;
+} Skimmer;
+
+typedef struct {
+    Skimmer* skimmer;
+    int index;
+} Worker;
+
+static void text_callback(char character, void* context) {
+    Channel* channel = context;
+    if(character == ' ' && channel->length == 0) return;
+    if(channel->length < LINE_LENGTH) channel->text[channel->length++] = character;
+}
+
+static void fft_setup(Skimmer* skimmer) {
+    size_t n = skimmer->fft_size;
+    skimmer->window = malloc(n * sizeof(float));
+    skimmer->twiddle_re = malloc(n / 2 * sizeof(float));
+    skimmer->twiddle_im = malloc(n / 2 * sizeof(float));
+    skimmer->bit_reverse = malloc(n * sizeof(size_t));
+
+    for(size_t i = 0; i < n; i++) {
+        skimmer->window[i] = (float)(0.5 - 0.5 * cos(2.0 * M_PI * i / n));
+    }
+    for(size_t i = 0; i < n / 2; i++) {
+        skimmer->twiddle_re[i] = (float)cos(2.0 * M_PI * i / n);
+        skimmer->twiddle_im[i] = (float)-sin(2.0 * M_PI * i / n);
+    }
+    size_t bits = 0;
+    while(((size_t)1 << bits) < n) bits++;
+    for(size_t i = 0; i < n; i++) {
+        size_t reversed = 0;
+        for(size_t b = 0; b < bits; b++) {
+            if(i & ((size_t)1 << b)) reversed |= (size_t)1 << (bits - 1 - b);
+        }
+        skimmer->bit_reverse[i] = reversed;
+    }
+}
+
+// Windowed radix-2 FFT of one frame, keeping the magnitudes of the watched bins
+static void fft_frame(const Skimmer* skimmer, size_t frame, float* re, float* im, float* out) {
+    size_t n = skimmer->fft_size;
+    const int16_t* input = skimmer->samples + frame * skimmer->hop;
+
+    for(size_t i = 0; i < n; i++) {
+        size_t j = skimmer->bit_reverse[i];
+        re[j] = input[i] * skimmer->window[i];
+        im[j] = 0;
+    }
+
+    for(size_t size = 2; size <= n; size *= 2) {
+        size_t half = size / 2;
+        size_t step = n / size;
+        for(size_t start = 0; start < n; start += size) {
+            for(size_t k = 0; k < half; k++) {
+                float wr = skimmer->twiddle_re[k * step];
+                float wi = skimmer->twiddle_im[k * step];
+                size_t a = start + k;
+                size_t b = a + half;
+                float tr = re[b] * wr - im[b] * wi;
+                float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+
+    const float* bin_re = re + skimmer->first_bin;
+    const float* bin_im = im + skimmer->first_bin;
+    for(size_t c = 0; c < skimmer->channel_count; c++) {
+        out[c] = sqrtf(bin_re[c] * bin_re[c] + bin_im[c] * bin_im[c]);
+    }
+}
+
+static void spectrum_pass(Skimmer* skimmer, int index) {
+    float* re = malloc(skimmer->fft_size * sizeof(float));
+    float* im = malloc(skimmer->fft_size * sizeof(float));
+
+    for(size_t f = index; f < skimmer->chunk_frames; f += skimmer->thread_count) {
+        fft_frame(skimmer, skimmer->chunk_start + f, re, im, skimmer->magnitude + f * skimmer->channel_count);
+    }
+
+    free(re);
+    free(im);
+}
+
+static void line_end(Skimmer* skimmer, Channel* channel, size_t frame) {
+    morse_decoder_flush(&channel->decoder);
+    while(channel->length > 0 && channel->text[channel->length - 1] == ' ') channel->length--;
+    channel->text[channel->length] = '\0';
+
+    size_t letters = 0;
+    for(size_t i = 0; i < channel->length; i++) letters += strchr(" ET", channel->text[i]) == NULL;
+    if(letters >= MIN_LINE_CHARS) {
+        if(channel->line_count == channel->line_capacity) {
+            channel->line_capacity = channel->line_capacity ? channel->line_capacity * 2 : 16;
+            channel->lines = realloc(channel->lines, channel->line_capacity * sizeof(Line));
+        }
+        Line* line = &channel->lines[channel->line_count++];
+        line->start_s = channel->line_start_s;
+        line->end_s = (double)frame * skimmer->hop / skimmer->rate;
+        line->peak = channel->line_peak;
+        memcpy(line->text, channel->text, channel->length + 1);
+    }
+
+    channel->in_line = false;
+    channel->length = 0;
+}
+
+// Feed a key edge to the channel decoder
+static void channel_edge(Skimmer* skimmer, Channel* channel, size_t frame, float peak) {
+    uint32_t duration_us = channel->run * skimmer->hop_us;
+
+    if(channel->key) {
+        morse_decoder_mark(&channel->decoder, duration_us);
+    } else if(channel->in_line) {
+        morse_decoder_space(&channel->decoder, duration_us);
+    } else {
+        channel->in_line = true;
+        channel->line_start_s = (double)frame * skimmer->hop / skimmer->rate;
+        channel->line_peak = 0;
+    }
+    if(peak > channel->line_peak) channel->line_peak = peak;
+
+    channel->key = !channel->key;
+    channel->run = 0;
+}
+
+static void channel_pass(Skimmer* skimmer, int index) {
+    size_t count = skimmer->channel_count;
+    size_t per_thread = (count + skimmer->thread_count - 1) / skimmer->thread_count;
+    size_t first = index * per_thread;
+    size_t last = first + per_thread < count ? first + per_thread : count;
+    if(first >= last) return;
+
+    float frame_ms = 1000.0f * skimmer->hop / skimmer->rate;
+    float noise_rate = frame_ms / NOISE_MS;
+    float peak_decay = 1.0f - frame_ms / PEAK_DECAY_MS;
+    uint32_t line_gap = (uint32_t)(LINE_GAP_MS / frame_ms);
+
+    float* noise = skimmer->noise;
+    float* peak = skimmer->peak;
+    uint8_t* key = skimmer->key;
+    uint8_t* detected = skimmer->detected;
+    uint8_t* previous = malloc(count);
+
+    for(size_t f = 0; f < skimmer->chunk_frames; f++) {
+        const float* level = skimmer->magnitude + f * count;
+        size_t frame = skimmer->chunk_start + f;
+        memcpy(previous + first, key + first, last - first);
+
+        // Envelope update across the owned channels, branch-free
+        for(size_t c = first; c < last; c++) {
+            float l = level[c];
+            float left = level[c > 0 ? c - 1 : c];
+            float right = level[c + 1 < count ? c + 1 : c];
+            float far_left = level[c > 1 ? c - 2 : c];
+            float far_right = level[c + 2 < count ? c + 2 : c];
+            float near = left > right ? left : right;
+            float far = far_left > far_right ? far_left : far_right;
+            float neighbour = near > far ? near : far;
+            float decayed = peak[c] * peak_decay;
+            peak[c] = l > decayed ? l : decayed;
+
+            // Frames in the upper half of the range are signal and stay out of the noise average
+            float span = peak[c] - noise[c];
+            noise[c] += (l > noise[c] + 0.5f * span ? 0.0f : noise_rate) * (l - noise[c]);
+            noise[c] = noise[c] > skimmer->noise_floor ? noise[c] : skimmer->noise_floor;
+            float threshold = noise[c] + (key[c] ? 0.35f : 0.5f) * span;
+            uint8_t active = peak[c] > MIN_SNR * noise[c];
+            uint8_t dominant = l >= NEIGHBOUR_RATIO * neighbour;
+            uint8_t raw = active & dominant & (l > threshold);
+
+            // Two frames in a row move the key, so one-frame splatter at a
+            // neighbour's key edges is ignored
+            key[c] = raw == detected[c] ? raw : key[c];
+            detected[c] = raw;
+        }
+
+        // Edges and silences go to the decoders
+        for(size_t c = first; c < last; c++) {
+            Channel* channel = &skimmer->channels[c];
+            if(key[c] != previous[c]) channel_edge(skimmer, channel, frame, peak[c]);
+            channel->run++;
+            if(!key[c] && channel->in_line && channel->run == line_gap) {
+                morse_decoder_space(&channel->decoder, channel->run * skimmer->hop_us);
+                line_end(skimmer, channel, frame);
+            }
+        }
+    }
+
+    free(previous);
+}
+
+static void* worker(void* context) {
+    Worker* worker = context;
+    if(worker->skimmer->pass == PassSpectrum) {
+        spectrum_pass(worker->skimmer, worker->index);
+    } else {
+        channel_pass(worker->skimmer, worker->index);
+    }
+    return NULL;
+}
+
+static void run_pass(Skimmer* skimmer, Pass pass, pthread_t* threads, Worker* workers) {
+    skimmer->pass = pass;
+    for(int i = 0; i < skimmer->thread_count; i++) {
+        pthread_create(&threads[i], NULL, worker, &workers[i]);
+    }
+    for(int i = 0; i < skimmer->thread_count; i++) pthread_join(threads[i], NULL);
+}
+
+static int compare_levels(const void* a, const void* b) {
+    float left = *(const float*)a;
+    float right = *(const float*)b;
+    return (left > right) - (left < right);
+}
+
+// Digital silence has no noise at all, so a floor under the strongest level
+// keeps window leakage in far channels from keying
+static void noise_floor_update(Skimmer* skimmer) {
+    size_t values = skimmer->chunk_frames * skimmer->channel_count;
+    for(size_t i = 0; i < values; i++) {
+        float floor = skimmer->magnitude[i] * NOISE_FLOOR_RATIO;
+        if(floor > skimmer->noise_floor) skimmer->noise_floor = floor;
+    }
+}
+
+// Seed each channel's noise from a low percentile of its first chunk, scaled
+// to the average it implies for plain noise. An average of the chunk itself
+// would include the keying, and a signal from the first second would then
+// sit under MIN_SNR until the average decayed.
+static void envelope_init(Skimmer* skimmer) {
+    float* levels = malloc(skimmer->chunk_frames * sizeof(float));
+    for(size_t c = 0; c < skimmer->channel_count; c++) {
+        for(size_t f = 0; f < skimmer->chunk_frames; f++) {
+            levels[f] = skimmer->magnitude[f * skimmer->channel_count + c];
+        }
+        qsort(levels, skimmer->chunk_frames, sizeof(float), compare_levels);
+        float noise = levels[skimmer->chunk_frames * NOISE_SEED_PERCENTILE / 100] * NOISE_SEED_SCALE;
+        skimmer->noise[c] = noise > skimmer->noise_floor ? noise : skimmer->noise_floor;
+        skimmer->peak[c] = skimmer->noise[c];
+    }
+    free(levels);
+}
+
+// A tone between two bins can be copied by both; keep the stronger copy of
+// lines that overlap for most of their length
+static bool duplicate_line(const Skimmer* skimmer, size_t c, const Line* line) {
+    for(int side = -1; side <= 1; side += 2) {
+        if((side < 0 && c == 0) || (side > 0 && c + 1 >= skimmer->channel_count)) continue;
+        const Channel* neighbour = &skimmer->channels[c + side];
+        for(size_t i = 0; i < neighbour->line_count; i++) {
+            const Line* other = &neighbour->lines[i];
+            double overlap = fmin(other->end_s, line->end_s) - fmax(other->start_s, line->start_s);
+            double shorter = fmin(other->end_s - other->start_s, line->end_s - line->start_s);
+            if(overlap > shorter / 2 && (other->peak > line->peak || (other->peak == line->peak && side < 0))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void print_transcripts(const Skimmer* skimmer) {
+    for(size_t c = 0; c < skimmer->channel_count; c++) {
+        const Channel* channel = &skimmer->channels[c];
+        bool header = false;
+
+        for(size_t i = 0; i < channel->line_count; i++) {
+            const Line* line = &channel->lines[i];
+            if(duplicate_line(skimmer, c, line)) continue;
+            if(!header) {
+                printf("%4.0f Hz\n", (double)(skimmer->first_bin + c) * skimmer->rate / skimmer->fft_size);
+                header = true;
+            }
+            int seconds = (int)line->start_s;
+            printf("  %02d:%02d:%02d.%d  %s\n",
+                seconds / 3600, seconds / 60 % 60, seconds % 60,
+                (int)((line->start_s - seconds) * 10), line->text);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    if(argc < 2) {
+        fprintf(stderr, "usage: %s <recording.wav> [-j threads] [-l low_hz] [-h high_hz] [-w wpm]\n", argv[0]);
+        return 2;
+    }
+
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int low_hz = DEFAULT_LOW_HZ;
+    int high_hz = DEFAULT_HIGH_HZ;
+    int wpm = DEFAULT_WPM;
+    for(int i = 2; i + 1 < argc; i += 2) {
+        if(strcmp(argv[i], "-j") == 0) {
+            threads = atoi(argv[i + 1]);
+        } else if(strcmp(argv[i], "-l") == 0) {
+            low_hz = atoi(argv[i + 1]);
+        } else if(strcmp(argv[i], "-h") == 0) {
+            high_hz = atoi(argv[i + 1]);
+        } else if(strcmp(argv[i], "-w") == 0) {
+            wpm = atoi(argv[i + 1]);
+        } else {
+            fprintf(stderr, "unknown option '%s'\n", argv[i]);
+            return 2;
+        }
+    }
+    if(threads < 1) threads = 1;
+    if(wpm < MIN_WPM || wpm > MAX_WPM) {
+        fprintf(stderr, "speed must be %d-%d WPM\n", MIN_WPM, MAX_WPM);
+        return 2;
+    }
+
+    Skimmer skimmer = {.thread_count = threads};
+    int16_t* samples;
+    if(!wav_read_mono(argv[1], &samples, &skimmer.sample_count, &skimmer.rate)) {
+        fprintf(stderr, "%s: not a 16-bit PCM WAV file\n", argv[1]);
+        return 1;
+    }
+    skimmer.samples = samples;
+
+    // Smallest power of two that keeps the bins narrower than the spacing
+    skimmer.fft_size = 16;
+    while(skimmer.rate / skimmer.fft_size > CHANNEL_SPACING_HZ) skimmer.fft_size *= 2;
+    skimmer.hop = skimmer.rate * HOP_MS / 1000;
+    skimmer.hop_us = (uint32_t)(1000000ull * skimmer.hop / skimmer.rate);
+
+    size_t nyquist_bin = skimmer.fft_size / 2;
+    size_t low_bin = (size_t)low_hz * skimmer.fft_size / skimmer.rate;
+    size_t high_bin = (size_t)high_hz * skimmer.fft_size / skimmer.rate;
+    if(low_bin < 1) low_bin = 1;
+    if(high_bin >= nyquist_bin) high_bin = nyquist_bin - 1;
+    if(skimmer.sample_count < skimmer.fft_size || high_bin < low_bin) {
+        fprintf(stderr, "%s: recording too short or pitch range empty\n", argv[1]);
+        free(samples);
+        return 1;
+    }
+    skimmer.first_bin = low_bin;
+    skimmer.channel_count = high_bin - low_bin + 1;
+    skimmer.frame_count = (skimmer.sample_count - skimmer.fft_size) / skimmer.hop + 1;
+
+    fft_setup(&skimmer);
+    skimmer.magnitude = malloc(CHUNK_FRAMES * skimmer.channel_count * sizeof(float));
+    skimmer.noise = calloc(skimmer.channel_count, sizeof(float));
+    skimmer.peak = calloc(skimmer.channel_count, sizeof(float));
+    skimmer.key = calloc(skimmer.channel_count, 1);
+    skimmer.detected = calloc(skimmer.channel_count, 1);
+    skimmer.channels = calloc(skimmer.channel_count, sizeof(Channel));
+    for(size_t c = 0; c < skimmer.channel_count; c++) {
+        morse_decoder_init(&skimmer.channels[c].decoder, (uint8_t)wpm, text_callback, &skimmer.channels[c]);
+    }
+
+    pthread_t* pool = malloc(threads * sizeof(pthread_t));
+    Worker* workers = malloc(threads * sizeof(Worker));
+    for(int i = 0; i < threads; i++) workers[i] = (Worker){.skimmer = &skimmer, .index = i};
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for(skimmer.chunk_start = 0; skimmer.chunk_start < skimmer.frame_count;
+        skimmer.chunk_start += skimmer.chunk_frames) {
+        size_t remaining = skimmer.frame_count - skimmer.chunk_start;
+        skimmer.chunk_frames = remaining < CHUNK_FRAMES ? remaining : CHUNK_FRAMES;
+        run_pass(&skimmer, PassSpectrum, pool, workers);
+        noise_floor_update(&skimmer);
+        if(skimmer.chunk_start == 0) envelope_init(&skimmer);
+        run_pass(&skimmer, PassChannels, pool, workers);
+    }
+    for(size_t c = 0; c < skimmer.channel_count; c++) {
+        if(skimmer.channels[c].in_line) line_end(&skimmer, &skimmer.channels[c], skimmer.frame_count);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    double audio_seconds = (double)skimmer.sample_count / skimmer.rate;
+
+    print_transcripts(&skimmer);
+    fprintf(stderr, "%zu channels of %.1f Hz, %.1f s of audio in %.2f s on %d threads (%.0fx real time)\n",
+        skimmer.channel_count, (double)skimmer.rate / skimmer.fft_size, audio_seconds, seconds, threads,
+        audio_seconds / (seconds > 0 ? seconds : 1e-9));
+
+    for(size_t c = 0; c < skimmer.channel_count; c++) free(skimmer.channels[c].lines);
+    free(skimmer.channels);
+    free(skimmer.key);
+    free(skimmer.detected);
+    free(skimmer.peak);
+    free(skimmer.noise);
+    free(skimmer.magnitude);
+    free(skimmer.window);
+    free(skimmer.twiddle_re);
+    free(skimmer.twiddle_im);
+    free(skimmer.bit_reverse);
+    free(workers);
+    free(pool);
+    free(samples);
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "wav.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t read_le16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void write_le32(uint8_t* p, uint32_t value) {
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+    p[2] = (value >> 16) & 0xFF;
+    p[3] = (value >> 24) & 0xFF;
+}
+
+static void write_le16(uint8_t* p, uint16_t value) {
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+}
+
+bool wav_read_mono(const char* path, int16_t** samples, size_t* count, uint32_t* rate) {
+    FILE* file = fopen(path, "rb");
+    if(!file) return false;
+
+    uint8_t riff[12];
+    bool ok = fread(riff, 1, sizeof(riff), file) == sizeof(riff) && memcmp(riff, "RIFF", 4) == 0 &&
+              memcmp(riff + 8, "WAVE", 4) == 0;
+    uint16_t channels = 0;
+    uint16_t bits = 0;
+    *samples = NULL;
+
+    // Walk the chunks until the data chunk, picking up the format on the way
+    while(ok) {
+        uint8_t chunk[8];
+        if(fread(chunk, 1, sizeof(chunk), file) != sizeof(chunk)) {
+            ok = false;
+            break;
+        }
+        uint32_t size = read_le32(chunk + 4);
+
+        if(memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t format[16];
+            if(size < sizeof(format) || fread(format, 1, sizeof(format), file) != sizeof(format)) {
+                ok = false;
+                break;
+            }
+            channels = read_le16(format + 2);
+            *rate = read_le32(format + 4);
+            bits = read_le16(format + 14);
+            if(read_le16(format) != 1 || bits != 16 || channels == 0) ok = false;
+            fseek(file, size - sizeof(format) + (size & 1), SEEK_CUR);
+        } else if(memcmp(chunk, "data", 4) == 0) {
+            if(channels == 0) {
+                ok = false;
+                break;
+            }
+            size_t frames = size / (2 * channels);
+            int16_t* frame = malloc(2 * channels);
+            *samples = malloc(frames * sizeof(int16_t) + 1);
+            size_t read = 0;
+            while(read < frames && fread(frame, 2, channels, file) == channels) {
+                (*samples)[read++] = frame[0];
+            }
+            free(frame);
+            *count = read;
+            break;
+        } else {
+            fseek(file, size + (size & 1), SEEK_CUR);
+        }
+    }
+
+    fclose(file);
+    if(!ok || !*samples) {
+        free(*samples);
+        *samples = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool wav_write_mono(const char* path, const int16_t* samples, size_t count, uint32_t rate) {
+    FILE* file = fopen(path, "wb");
+    if(!file) return false;
+
+    uint8_t header[44];
+    uint32_t data_size = (uint32_t)(count * sizeof(int16_t));
+    memcpy(header, "RIFF", 4);
+    write_le32(header + 4, 36 + data_size);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    write_le32(header + 16, 16);
+    write_le16(header + 20, 1);     // PCM
+    write_le16(header + 22, 1);     // Mono
+    write_le32(header + 24, rate);
+    write_le32(header + 28, rate * 2);
+    write_le16(header + 32, 2);
+    write_le16(header + 34, 16);
+    memcpy(header + 36, "data", 4);
+    write_le32(header + 40, data_size);
+
+    bool ok = fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+              fwrite(samples, sizeof(int16_t), count, file) == count;
+    return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// Minimal 16-bit PCM WAV reading and writing for the host tools
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Read a 16-bit PCM file, keeping only the first channel. The caller frees *samples.
+bool wav_read_mono(const char* path, int16_t** samples, size_t* count, uint32_t* rate);
+
+// Write a mono 16-bit PCM file
+bool wav_write_mono(const char* path, const int16_t* samples, size_t count, uint32_t rate);